@@ -67,3 +67,28 @@ class LobbyCodeSerializer(serializers.Serializer):
         if not all(c in allowed_chars for c in value):
             raise serializers.ValidationError("Lobby code must contain only uppercase letters and digits.")
         return value
+
+
+class MatchPlayerSerializer(serializers.Serializer):
+    """Serializer for one player in a match result."""
+    
+    id = serializers.CharField(allow_blank=True)
+    username = serializers.CharField(allow_blank=True)
+
+
+class MatchResultSerializer(serializers.Serializer):
+    """Serializer for a finished match reported by the C++ game server."""
+    
+    lobby = serializers.CharField(allow_blank=True)
+    players = serializers.ListField(child=MatchPlayerSerializer(), min_length=2, max_length=2)
+    winner = serializers.CharField(allow_blank=True)
+    outcome = serializers.ChoiceField(choices=["completed", "abandoned"])
+    moves = serializers.IntegerField(min_value=0)
+    started_at = serializers.IntegerField(min_value=0)
+    duration_ms = serializers.IntegerField(min_value=0)
+
+    def validate(self, attrs):
+        """Validate that the winner is one of the players."""
+        if attrs['winner'] not in [player['id'] for player in attrs['players']]:
+            raise serializers.ValidationError({"winner": "Winner must be one of the players."})
+        return attrs
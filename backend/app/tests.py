@@ -1,3 +1,149 @@
 """Test cases for the battleship game application."""
 
-from django.test import TestCase
+import copy
+import urllib.error
+from unittest import mock
+
+from django.contrib.auth.models import User
+from django.test import SimpleTestCase, override_settings
+from django.urls import reverse
+from rest_framework.test import APIClient
+
+
+TOKEN = 'test-internal-token'
+
+MATCH = {
+    "lobby": "ABC123",
+    "players": [
+        {"id": "1", "username": "alice"},
+        {"id": "2", "username": "bob"}
+    ],
+    "winner": "1",
+    "outcome": "completed",
+    "moves": 42,
+    "started_at": 1700000000000,
+    "duration_ms": 120000
+}
+
+
+@override_settings(INTERNAL_API_TOKEN=TOKEN)
+@mock.patch('app.views.matches_col')
+class MatchResultsViewTests(SimpleTestCase):
+    """Tests for the endpoint the C++ server reports finished matches to."""
+
+    def setUp(self):
+        self.client = APIClient()
+        self.url = reverse('match_results')
+
+    def post(self, data, token=TOKEN):
+        """Post match results, sending the internal token if one is given."""
+        headers = {'HTTP_X_INTERNAL_TOKEN': token} if token is not None else {}
+        return self.client.post(self.url, data, format='json', **headers)
+
+    def match(self, **changes):
+        """Build a valid match document with some fields replaced."""
+        doc = copy.deepcopy(MATCH)
+        doc.update(changes)
+        return doc
+
+    def test_stores_valid_batch(self, matches_col):
+        response = self.post([self.match(), self.match(lobby="XYZ789", outcome="abandoned")])
+
+        self.assertEqual(response.status_code, 201)
+        self.assertEqual(response.data["count"], 2)
+        stored = matches_col.insert_many.call_args[0][0]
+        self.assertEqual([doc["lobby"] for doc in stored], ["ABC123", "XYZ789"])
+        self.assertEqual(stored[0]["players"][1]["username"], "bob")
+
+    def test_empty_batch_stores_nothing(self, matches_col):
+        response = self.post([])
+
+        self.assertEqual(response.status_code, 201)
+        self.assertEqual(response.data["count"], 0)
+        matches_col.insert_many.assert_not_called()
+
+    def test_rejects_missing_token(self, matches_col):
+        response = self.post([self.match()], token=None)
+
+        self.assertEqual(response.status_code, 403)
+        matches_col.insert_many.assert_not_called()
+
+    def test_rejects_wrong_token(self, matches_col):
+        response = self.post([self.match()], token='wrong')
+
+        self.assertEqual(response.status_code, 403)
+        matches_col.insert_many.assert_not_called()
+
+    @override_settings(INTERNAL_API_TOKEN='')
+    def test_rejects_everything_without_configured_token(self, matches_col):
+        for token in (None, ''):
+            response = self.post([self.match()], token=token)
+            self.assertEqual(response.status_code, 403)
+        matches_col.insert_many.assert_not_called()
+
+    def test_rejects_non_list_body(self, matches_col):
+        response = self.post(self.match())
+
+        self.assertEqual(response.status_code, 400)
+        matches_col.insert_many.assert_not_called()
+
+    def test_rejects_bad_documents(self, matches_col):
+        bad_documents = [
+            "not a document",
+            {key: value for key, value in MATCH.items() if key != "winner"},
+            self.match(players=[{"id": "1", "username": "alice"}]),
+            self.match(players=[{"id": "1"}, {"id": "2", "username": "bob"}]),
+            self.match(winner="3"),
+            self.match(outcome="draw"),
+            self.match(moves=-1),
+            self.match(moves="many"),
+            self.match(started_at=None),
+            self.match(duration_ms=-5),
+        ]
+        for doc in bad_documents:
+            with self.subTest(doc=doc):
+                response = self.post([self.match(), doc])
+                self.assertEqual(response.status_code, 400)
+        matches_col.insert_many.assert_not_called()
+
+
+@mock.patch('app.utils.lobbies_col')
+@mock.patch('app.views.store_new_lobby', return_value=True)
+@mock.patch('app.utils.urllib.request.urlopen')
+class CreateLobbyViewTests(SimpleTestCase):
+    """Tests for lobby creation through the C++ server's code allocator."""
+
+    def setUp(self):
+        self.client = APIClient()
+        self.client.force_authenticate(user=User(id=1, username='alice'))
+        self.url = reverse('create_lobby')
+
+    def test_uses_allocated_code(self, urlopen, store_new_lobby, lobbies_col):
+        urlopen.return_value.__enter__.return_value.read.return_value = b'{"code": "ABC123"}'
+
+        response = self.client.post(self.url)
+
+        self.assertEqual(response.status_code, 201)
+        self.assertEqual(response.data["code"], "ABC123")
+        lobbies_col.find_one.assert_not_called()
+
+    def test_unreachable_allocator_falls_back_to_mongo(self, urlopen, store_new_lobby, lobbies_col):
+        urlopen.side_effect = urllib.error.URLError("connection refused")
+        lobbies_col.find_one.return_value = None
+
+        with self.assertLogs('app.utils', level='WARNING'):
+            response = self.client.post(self.url)
+
+        self.assertEqual(response.status_code, 201)
+        lobbies_col.find_one.assert_called()
+
+    def test_refused_allocation_is_reported(self, urlopen, store_new_lobby, lobbies_col):
+        urlopen.side_effect = urllib.error.HTTPError(
+            'http://localhost:9002/lobbies', 403, 'Forbidden', {}, None)
+
+        with self.assertLogs('app.utils', level='ERROR'):
+            response = self.client.post(self.url)
+
+        self.assertEqual(response.status_code, 503)
+        lobbies_col.find_one.assert_not_called()
+        store_new_lobby.assert_not_called()
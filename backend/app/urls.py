@@ -4,7 +4,7 @@ from django.urls import path
 from .views import (
     RegisterView, LoginView, AuthView, LogoutView,
     DashboardView, CreateLobbyView, JoinLobbyView, StartGameView, LobbyStatusView,
-    GameView
+    GameView, MatchResultsView
 )
 
 urlpatterns = [
@@ -17,5 +17,6 @@ urlpatterns = [
     path('start_game/', StartGameView.as_view(), name='start_game'),
     path('lobby_status/', LobbyStatusView.as_view(), name='lobby_status'),
     path('game/<str:lobby_code>/', GameView.as_view(), name='game'),
+    path('match_results/', MatchResultsView.as_view(), name='match_results'),
     path('', AuthView.as_view(), name='auth'),
 ]
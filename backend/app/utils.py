@@ -1,8 +1,12 @@
 """Utility functions and database connections for the battleship game."""
 
+import json
+import logging
 import os
 import random
 import string
+import urllib.error
+import urllib.request
 from pymongo import MongoClient
 from django.conf import settings
 
@@ -14,15 +18,69 @@ client = MongoClient(mongo_uri)
 db = client[mongo_db_name]
 users_col = db['users']
 lobbies_col = db['lobbies']
+matches_col = db['matches']
+
+logger = logging.getLogger(__name__)
+
+
+class LobbyAllocatorError(Exception):
+    """The C++ game server answered a lobby code request with an error."""
 
 
 def generate_unique_lobby_code():
     """Generate a unique 6-character lobby code consisting of uppercase letters and digits.
     
+    Codes are allocated by the C++ game server, which tracks live lobbies in
+    memory. If the server cannot be reached, fall back to probing MongoDB.
+    An error answer (such as a 403 for a mismatched internal token) is not a
+    reason to fall back: it would never go away, so it is raised instead.
+    
     Returns:
         str: A unique lobby code that doesn't exist in the database.
+    
+    Raises:
+        LobbyAllocatorError: If the game server refused or garbled the request.
     """
+    try:
+        request = urllib.request.Request(
+            settings.LOBBY_ALLOCATOR_URL, data=b'', method='POST',
+            headers={'X-Internal-Token': settings.INTERNAL_API_TOKEN}
+        )
+        with urllib.request.urlopen(request, timeout=2) as response:
+            return json.loads(response.read())['code']
+    except urllib.error.HTTPError as error:
+        # HTTPError is also a URLError, so it must be caught first
+        logger.error("Lobby allocator answered HTTP %s", error.code)
+        raise LobbyAllocatorError(f"Lobby allocator answered HTTP {error.code}") from error
+    except (ValueError, KeyError) as error:
+        logger.error("Lobby allocator sent an unreadable answer: %r", error)
+        raise LobbyAllocatorError("Lobby allocator sent an unreadable answer") from error
+    except (urllib.error.URLError, OSError) as error:
+        logger.warning("Lobby allocator unreachable, probing MongoDB instead: %s", error)
+
     while True:
         code = ''.join(random.choices(string.ascii_uppercase + string.digits, k=6))
         if not lobbies_col.find_one({"code": code}):
-            return code
\ No newline at end of file
+            return code
+
+
+def store_new_lobby(lobby):
+    """Store a new lobby document without disturbing a live lobby.
+    
+    Codes are recycled once a game ends, so a document left behind by a
+    finished game may be replaced. A waiting or ready lobby that still holds
+    the code is left alone.
+    
+    Args:
+        lobby (dict): Lobby document to store.
+    
+    Returns:
+        bool: True if the lobby was stored, False if its code is still in use.
+    """
+    result = lobbies_col.replace_one({"code": lobby["code"], "status": "in_progress"}, lobby)
+    if result.matched_count:
+        return True
+
+    # $setOnInsert leaves an existing document untouched
+    result = lobbies_col.update_one({"code": lobby["code"]}, {"$setOnInsert": lobby}, upsert=True)
+    return result.upserted_id is not None
\ No newline at end of file
@@ -1,5 +1,6 @@
 """API views for the battleship game application."""
 
+import hmac
 from django.shortcuts import render, redirect
 from django.contrib.auth import authenticate, login, logout
 from django.contrib.auth.models import User
@@ -9,8 +10,12 @@ from rest_framework.response import Response
 from rest_framework import status
 from rest_framework.permissions import IsAuthenticated
 
-from .serializers import RegisterSerializer, LoginSerializer, LobbyCodeSerializer
-from .utils import lobbies_col, generate_unique_lobby_code
+from .serializers import RegisterSerializer, LoginSerializer, LobbyCodeSerializer, MatchResultSerializer
+from .utils import (lobbies_col, matches_col, generate_unique_lobby_code, store_new_lobby,
+                    LobbyAllocatorError)
+
+# Attempts at finding a lobby code that no live lobby document holds
+LOBBY_CODE_ATTEMPTS = 5
 
 
 class AuthView(APIView):
@@ -84,20 +89,27 @@ class CreateLobbyView(APIView):
 
     def post(self, request):
         """Create a new lobby with unique code."""
-        code = generate_unique_lobby_code()
+        for _ in range(LOBBY_CODE_ATTEMPTS):
+            try:
+                code = generate_unique_lobby_code()
+            except LobbyAllocatorError:
+                break
 
-        lobby = {
-            "code": code,
-            "players": [request.user.id],
-            "status": "waiting"
-        }
+            lobby = {
+                "code": code,
+                "players": [request.user.id],
+                "status": "waiting"
+            }
 
-        lobbies_col.insert_one(lobby)
+            if store_new_lobby(lobby):
+                return Response({
+                    "message": "Lobby created successfully",
+                    "code": code
+                }, status=status.HTTP_201_CREATED)
 
         return Response({
-            "message": "Lobby created successfully",
-            "code": code
-        }, status=status.HTTP_201_CREATED)
+            "message": "Could not allocate a lobby code"
+        }, status=status.HTTP_503_SERVICE_UNAVAILABLE)
 
 
 class JoinLobbyView(APIView):
@@ -235,6 +247,41 @@ class LobbyStatusView(APIView):
         }, status=status.HTTP_200_OK)
 
 
+class MatchResultsView(APIView):
+    """Store finished match results reported by the C++ game server."""
+    
+    authentication_classes = []
+    permission_classes = []
+
+    def post(self, request):
+        """Insert a batch of match result documents."""
+        # Fail closed: with no token configured, nothing may write results
+        token = settings.INTERNAL_API_TOKEN
+        supplied = request.headers.get('X-Internal-Token', '')
+        if not token or not hmac.compare_digest(supplied.encode(), token.encode()):
+            return Response({
+                "message": "Invalid internal token"
+            }, status=status.HTTP_403_FORBIDDEN)
+
+        if not isinstance(request.data, list):
+            return Response({
+                "message": "Expected a list of match results"
+            }, status=status.HTTP_400_BAD_REQUEST)
+
+        serializer = MatchResultSerializer(data=request.data, many=True)
+        if not serializer.is_valid():
+            return Response(serializer.errors, status=status.HTTP_400_BAD_REQUEST)
+
+        results = serializer.validated_data
+        if results:
+            matches_col.insert_many([dict(result) for result in results], ordered=False)
+
+        return Response({
+            "message": "Match results stored",
+            "count": len(results)
+        }, status=status.HTTP_201_CREATED)
+
+
 class LogoutView(APIView):
     """Handle user logout."""
     
@@ -7,12 +7,16 @@ SECRET_KEY = 'django-insecure-%ha#0(kbay-r(09cu4%7mrvn!5r3fg%wmb_!6pab27r^#$^z85
 
 DEBUG = True
 
-ALLOWED_HOSTS = ['localhost', '127.0.0.1', 'django-app']
+ALLOWED_HOSTS = ['localhost', '127.0.0.1', 'django-app', 'django-backend']
 
 # WebSocket configuration
 WEBSOCKET_HOST = os.environ.get('WEBSOCKET_HOST', 'localhost')
 WEBSOCKET_PORT = os.environ.get('WEBSOCKET_PORT', '9002')
 WEBSOCKET_URL = f'ws://localhost:{WEBSOCKET_PORT}'
+LOBBY_ALLOCATOR_URL = os.environ.get(
+    'LOBBY_ALLOCATOR_URL', f'http://{WEBSOCKET_HOST}:{WEBSOCKET_PORT}/lobbies'
+)
+INTERNAL_API_TOKEN = os.environ.get('INTERNAL_API_TOKEN', '')
 
 INSTALLED_APPS = [
     'django.contrib.admin',
@@ -11,18 +11,25 @@
 #include <nlohmann/json.hpp>
 #include <iostream>
 #include <memory>
-#include <map>
 #include <string>
 #include <functional>
-#include "game.hpp"
-#include "lobby.hpp"
+#include <cstdlib>
+#include "match_recorder.hpp"
+#include "process_stats.hpp"
+#include "server_config.hpp"
+#include "session_manager.hpp"
+#include "trace.hpp"
 
 using json = nlohmann::json;
 using websocketpp::lib::placeholders::_1;
 using websocketpp::lib::placeholders::_2;
 using websocketpp::lib::bind;
 
+#ifdef BATTLESHIP_HIGH_DENSITY
+typedef websocketpp::server<density_config> server;
+#else
 typedef websocketpp::server<websocketpp::config::asio> server;
+#endif
 typedef server::message_ptr message_ptr;
 typedef websocketpp::connection_hdl connection_hdl;
 
@@ -34,8 +41,15 @@ class BattleshipServer {
 public:
     /**
      * @brief Constructor - initializes WebSocket server and event handlers
+     * @param internalToken Shared secret internal HTTP callers must send; if empty they are refused
+     * @param matchRecorder Destination for finished matches, may be null
      */
-    BattleshipServer() {
+    explicit BattleshipServer(const std::string& internalToken = "",
+                              std::unique_ptr<MatchRecorder> matchRecorder = nullptr)
+        : m_internalToken(internalToken), m_matchRecorder(std::move(matchRecorder)),
+          m_sessions([this](connection_hdl hdl, const json& data) { send(hdl, data); },
+                     m_matchRecorder.get()),
+          m_openConnections(0), m_baselineRss(0) {
         m_server.init_asio();
         m_server.clear_access_channels(websocketpp::log::alevel::all);
         m_server.set_access_channels(websocketpp::log::alevel::app);
@@ -43,6 +57,7 @@ public:
         m_server.set_open_handler(bind(&BattleshipServer::on_open, this, _1));
         m_server.set_close_handler(bind(&BattleshipServer::on_close, this, _1));
         m_server.set_message_handler(bind(&BattleshipServer::on_message, this, _1, _2));
+        m_server.set_http_handler(bind(&BattleshipServer::on_http, this, _1));
     }
 
     /**
@@ -50,7 +65,12 @@ public:
      * @param port Port number to listen on
      */
     void run(uint16_t port) {
+#ifdef BATTLESHIP_HIGH_DENSITY
+        m_server.set_reuse_addr(true);
+        m_server.set_listen_backlog(4096);
+#endif
         m_server.listen(port);
+        m_baselineRss = getResidentBytes();
         std::cout << "Battleship server listening on port " << port << std::endl;
         m_server.start_accept();
         m_server.run();
@@ -58,14 +78,17 @@ public:
 
 private:
     server m_server;
-    std::map<connection_hdl, std::string, std::owner_less<connection_hdl>> m_connections;
-    std::map<std::string, std::unique_ptr<Lobby>> m_lobbies;
-    std::map<std::string, std::unique_ptr<Game>> m_games;
+    std::string m_internalToken;   ///< Expected X-Internal-Token for internal HTTP calls
+    std::unique_ptr<MatchRecorder> m_matchRecorder;
+    SessionManager m_sessions;     ///< Players, lobbies and games
+    size_t m_openConnections;   ///< Open WebSocket connections, joined or not
+    size_t m_baselineRss;       ///< Resident bytes before accepting connections
 
     /**
      * @brief Handle new WebSocket connection
      */
     void on_open(connection_hdl hdl) {
+        m_openConnections++;
         std::cout << "Connection opened" << std::endl;
     }
 
@@ -73,65 +96,32 @@ private:
      * @brief Handle WebSocket connection closure and cleanup
      */
     void on_close(connection_hdl hdl) {
+        // Don't tag close-time sends with the last message's lobby; each
+        // channel's departure notices are tagged with their own lobby
+        TraceSpan::setLobby("");
+        m_openConnections--;
         std::cout << "Connection closed" << std::endl;
         
-        auto it = m_connections.find(hdl);
-        if (it != m_connections.end()) {
-            std::string userId = it->second;
-            
-            for (auto& lobby_pair : m_lobbies) {
-                Lobby& lobby = *lobby_pair.second;
-                if (lobby.hasPlayer(userId)) {
-                    lobby.removePlayer(userId);
-                    notifyLobbyUpdate(lobby);
-                    break;
-                }
-            }
-            
-            for (auto& game_pair : m_games) {
-                Game& game = *game_pair.second;
-                if (game.hasPlayer(userId)) {
-                    game.playerDisconnected(userId);
-                    
-                    std::string opponentId = game.getOpponentId(userId);
-                    if (!opponentId.empty()) {
-                        connection_hdl opponent_hdl = getConnectionByUserId(opponentId);
-                        if (opponent_hdl.lock()) {
-                            json msg = {
-                                {"type", "opponentDisconnected"},
-                                {"message", "Your opponent has disconnected from the game."}
-                            };
-                            send(opponent_hdl, msg);
-                        }
-                    }
-                    break;
-                }
-            }
-            
-            m_connections.erase(it);
-        }
+        m_sessions.closeConnection(hdl);
     }
 
     /**
      * @brief Process incoming WebSocket messages
      */
     void on_message(connection_hdl hdl, message_ptr msg) {
+        TraceSpan::setLobby("");
+        TraceSpan handleSpan("handle");
+        
         try {
-            json data = json::parse(msg->get_payload());
-            std::string messageType = data.value("type", "");
-            
-            if (messageType == "join") {
-                handleJoinMessage(hdl, data);
-            }
-            else if (messageType == "ready") {
-                handleReadyMessage(hdl, data);
-            }
-            else if (messageType == "attack") {
-                handleAttackMessage(hdl, data);
-            }
-            else {
-                std::cout << "Unknown message type: " << messageType << std::endl;
+            json data;
+            {
+                TraceSpan parseSpan("parse");
+                data = json::parse(msg->get_payload());
+                TraceSpan::setLobby(data.value("lobby", ""));
             }
+            
+            TraceSpan logicSpan("logic");
+            m_sessions.handleMessage(hdl, data);
         } 
         catch (const std::exception& e) {
             std::cerr << "Error processing message: " << e.what() << std::endl;
@@ -139,197 +129,85 @@ private:
     }
 
     /**
-     * @brief Handle player joining a lobby
+     * @brief Serve plain HTTP requests on the WebSocket listener
+     *
+     * POST /lobbies allocates a fresh lobby code for the Django backend.
+     * GET /stats reports connection counts and memory use per connection.
+     * GET /trace dumps buffered trace spans in Chrome trace format.
+     * All of them require the internal token: the trace names live lobbies.
      */
-    void handleJoinMessage(connection_hdl hdl, const json& data) {
-        std::string lobbyCode = data.value("lobby", "");
-        std::string userId = data.value("user", "");
-        std::string username = data.value("username", "");
+    void on_http(connection_hdl hdl) {
+        server::connection_ptr con = m_server.get_con_from_hdl(hdl);
+        const std::string& method = con->get_request().get_method();
+        std::string resource = con->get_resource();
         
-        std::cout << "Player " << username << " (ID: " << userId << ") joining lobby " << lobbyCode << std::endl;
-        
-        m_connections[hdl] = userId;
-        
-        if (m_lobbies.find(lobbyCode) == m_lobbies.end()) {
-            m_lobbies[lobbyCode] = std::make_unique<Lobby>(lobbyCode);
-        }
-        
-        Lobby& lobby = *m_lobbies[lobbyCode];
-        Player player{userId, username, hdl};
-        lobby.addPlayer(player);
-        
-        if (lobby.getPlayerCount() == 2) {
-            Player firstPlayer = lobby.getPlayers()[0];
-            json notification = {
-                {"type", "opponentJoined"},
-                {"username", username}
-            };
-            send(firstPlayer.hdl, notification);
-        }
-        
-        json confirmation = {
-            {"type", "joinConfirmed"},
-            {"message", "Successfully joined lobby " + lobbyCode}
-        };
-        send(hdl, confirmation);
-    }
-
-    /**
-     * @brief Handle player ready status with ship placement
-     */
-    void handleReadyMessage(connection_hdl hdl, const json& data) {
-        std::string userId = data.value("user", "");
-        json board = data.value("board", json::object());
-        
-        std::cout << "Player " << userId << " is ready with " << board.size() << " ships" << std::endl;
-        
-        for (auto& lobby_pair : m_lobbies) {
-            Lobby& lobby = *lobby_pair.second;
-            if (lobby.hasPlayer(userId)) {
-                std::cout << "Found player in lobby " << lobby.getLobbyCode() << std::endl;
-                
-                lobby.setPlayerReady(userId, board);
-                
-                std::cout << "Player count: " << lobby.getPlayerCount() 
-                         << ", All ready: " << lobby.areAllPlayersReady() << std::endl;
-                
-                if (lobby.areAllPlayersReady()) {
-                    std::cout << "Starting game for lobby " << lobby.getLobbyCode() << std::endl;
-                    startGame(lobby);
-                    return;
-                } else {
-                    std::cout << "Not all players ready yet" << std::endl;
-                }
-                break;
+        json body;
+        bool known = resource == "/lobbies" || resource == "/stats" || resource == "/trace";
+        if (known && !hasInternalToken(con)) {
+            body = {{"message", "Invalid internal token"}};
+            con->set_status(websocketpp::http::status_code::forbidden);
+        } else if (resource == "/lobbies") {
+            if (method == "POST") {
+                body = {{"code", m_sessions.allocateLobbyCode()}};
+                con->set_status(websocketpp::http::status_code::created);
+            } else {
+                body = {{"message", "Method not allowed"}};
+                con->set_status(websocketpp::http::status_code::method_not_allowed);
             }
-        }
-    }
-
-    /**
-     * @brief Handle attack messages during gameplay
-     */
-    void handleAttackMessage(connection_hdl hdl, const json& data) {
-        auto conn_it = m_connections.find(hdl);
-        if (conn_it == m_connections.end()) return;
-        
-        std::string userId = conn_it->second;
-        int x = data.value("x", -1);
-        int y = data.value("y", -1);
-        
-        if (x < 0 || y < 0 || x >= 10 || y >= 10) {
-            std::cerr << "Invalid attack coordinates: " << x << "," << y << std::endl;
-            return;
-        }
-        
-        for (auto& game_pair : m_games) {
-            Game& game = *game_pair.second;
-            if (game.hasPlayer(userId)) {
-                AttackResult result = game.processAttack(userId, x, y);
-                
-                json attackerMsg = {
-                    {"type", "attackResult"},
-                    {"x", x},
-                    {"y", y},
-                    {"hit", result.hit},
-                    {"sunk", result.shipSunk},
-                    {"nextPlayer", result.nextPlayerId},
-                    {"gameOver", result.gameOver},
-                    {"winner", result.winnerId}
-                };
-                send(hdl, attackerMsg);
-                
-                std::string defenderId = game.getOpponentId(userId);
-                connection_hdl defender_hdl = getConnectionByUserId(defenderId);
-                
-                json defenderMsg = {
-                    {"type", "attacked"},
-                    {"x", x},
-                    {"y", y},
-                    {"hit", result.hit},
-                    {"sunk", result.shipSunk},
-                    {"nextPlayer", result.nextPlayerId},
-                    {"gameOver", result.gameOver},
-                    {"winner", result.winnerId}
-                };
-                send(defender_hdl, defenderMsg);
-                
-                if (result.gameOver) {
-                    json gameOverMsg = {
-                        {"type", "gameOver"},
-                        {"winner", result.winnerId}
-                    };
-                    
-                    send(hdl, gameOverMsg);
-                    send(defender_hdl, gameOverMsg);
-                    
-                    std::string lobbyCode = game.getLobbyCode();
-                    m_games.erase(lobbyCode);
-                }
-                break;
-            }
-        }
-    }
-
-    /**
-     * @brief Initialize a new game from a ready lobby
-     */
-    void startGame(Lobby& lobby) {
-        std::string lobbyCode = lobby.getLobbyCode();
-        std::vector<Player> players = lobby.getPlayers();
-        
-        std::cout << "Starting game with " << players.size() << " players in lobby " << lobbyCode << std::endl;
-        
-        if (players.size() != 2) {
-            std::cerr << "Cannot start game without exactly 2 players" << std::endl;
+        } else if (resource == "/stats" && method == "GET") {
+            body = getStats();
+            con->set_status(websocketpp::http::status_code::ok);
+        } else if (resource == "/trace" && method == "GET") {
+            // Served as text: building a DOM for full rings is too slow for the io thread
+            con->append_header("Content-Type", "application/json");
+            con->set_body(Tracer::dumpChromeTrace());
+            con->set_status(websocketpp::http::status_code::ok);
             return;
+        } else {
+            body = {{"message", "Not found"}};
+            con->set_status(websocketpp::http::status_code::not_found);
         }
         
-        m_games[lobbyCode] = std::make_unique<Game>(lobbyCode, players[0], players[1], 
-            lobby.getPlayerBoard(players[0].id), lobby.getPlayerBoard(players[1].id));
-        
-        Game& game = *m_games[lobbyCode];
-        int firstPlayerIdx = game.decideFirstPlayer();
-        std::string firstPlayerId = players[firstPlayerIdx].id;
-        
-        std::cout << "First player: " << firstPlayerId << " (index " << firstPlayerIdx << ")" << std::endl;
-        
-        for (const Player& player : players) {
-            json startMsg = {
-                {"type", "gameStart"},
-                {"firstPlayer", firstPlayerId}
-            };
-            std::cout << "Sending gameStart message to player " << player.id << std::endl;
-            send(player.hdl, startMsg);
-        }
-        
-        m_lobbies.erase(lobbyCode);
-        std::cout << "Game started successfully, lobby removed" << std::endl;
+        con->append_header("Content-Type", "application/json");
+        con->set_body(body.dump());
     }
 
     /**
-     * @brief Notify players of lobby changes (placeholder for future use)
+     * @brief Check that an HTTP request carries the internal token
+     *
+     * Fails closed: with no token configured every request is refused.
      */
-    void notifyLobbyUpdate(const Lobby& lobby) {
-        // Future implementation for lobby updates
+    bool hasInternalToken(server::connection_ptr con) const {
+        return !m_internalToken.empty() &&
+            con->get_request_header("X-Internal-Token") == m_internalToken;
     }
 
     /**
-     * @brief Find connection handle by user ID
+     * @brief Collect server counters for the stats endpoint
      */
-    connection_hdl getConnectionByUserId(const std::string& userId) {
-        connection_hdl empty;
-        for (const auto& conn : m_connections) {
-            if (conn.second == userId) {
-                return conn.first;
-            }
+    json getStats() const {
+        size_t rss = getResidentBytes();
+        size_t growth = rss > m_baselineRss ? rss - m_baselineRss : 0;
+        
+        json stats = m_sessions.getStats();
+        stats["connections"] = m_openConnections;
+        stats["rssBytes"] = rss;
+        stats["baselineRssBytes"] = m_baselineRss;
+        stats["bytesPerConnection"] = m_openConnections ? growth / m_openConnections : 0;
+        if (m_matchRecorder) {
+            stats["matchRecorder"] = m_matchRecorder->getStats();
         }
-        return empty;
+        return stats;
     }
 
     /**
      * @brief Send JSON message to a specific connection
+     *
+     * Only queues the frame; websocketpp writes it after the handler returns,
+     * so the span measures serialization and the enqueue, not the socket write.
      */
     void send(connection_hdl hdl, const json& data) {
+        TraceSpan enqueueSpan("enqueue");
         try {
             m_server.send(hdl, data.dump(), websocketpp::frame::opcode::text);
         } catch (const std::exception& e) {
@@ -343,7 +221,31 @@ private:
  */
 int main() {
     try {
-        BattleshipServer server;
+        const char* traceSetting = std::getenv("BATTLESHIP_TRACE");
+        if (traceSetting && std::string(traceSetting) == "0") {
+            Tracer::setEnabled(false);
+        }
+        
+        const char* tokenSetting = std::getenv("INTERNAL_API_TOKEN");
+        std::string internalToken = tokenSetting ? tokenSetting : "";
+        if (internalToken.empty()) {
+            std::cerr << "INTERNAL_API_TOKEN is not set, internal HTTP endpoints are disabled" << std::endl;
+        }
+        
+        std::unique_ptr<MatchRecorder> matchRecorder;
+        const char* sinkTarget = std::getenv("MATCH_SINK");
+        if (sinkTarget && *sinkTarget) {
+            const char* spillPath = std::getenv("MATCH_SPILL_PATH");
+            std::unique_ptr<MatchSink> sink = makeMatchSink(sinkTarget, internalToken);
+            if (sink) {
+                matchRecorder.reset(new MatchRecorder(std::move(sink),
+                    spillPath ? spillPath : "match_results.spill"));
+            } else {
+                std::cerr << "Unrecognised MATCH_SINK, match results will not be recorded" << std::endl;
+            }
+        }
+        
+        BattleshipServer server(internalToken, std::move(matchRecorder));
         server.run(9002);
     } catch (const std::exception& e) {
         std::cerr << "Exception: " << e.what() << std::endl;
@@ -4,12 +4,13 @@
  */
 
 #include "game.hpp"
-#include <random>
 
 Game::Game(const std::string& lobbyCode, const Player& player1, const Player& player2,
            const json& board1, const json& board2)
     : m_lobbyCode(lobbyCode), m_player1(player1), m_player2(player2), 
-      m_board1(board1), m_board2(board2) {
+      m_board1(board1), m_board2(board2), m_moveCount(0),
+      m_startTime(std::chrono::system_clock::now()),
+      m_startTick(std::chrono::steady_clock::now()) {
     
     m_remainingShips[player1.id] = board1.size();
     m_remainingShips[player2.id] = board2.size();
@@ -29,6 +30,10 @@ Game::Game(const std::string& lobbyCode, const Player& player1, const Player& pl
 int Game::decideFirstPlayer() {
     std::random_device rd;
     std::mt19937 gen(rd());
+    return decideFirstPlayer(gen);
+}
+
+int Game::decideFirstPlayer(std::mt19937& gen) {
     std::uniform_int_distribution<> distrib(0, 1);
     
     int firstPlayer = distrib(gen);
@@ -56,6 +61,7 @@ AttackResult Game::processAttack(const std::string& attackerId, int x, int y) {
     }
     
     m_playerHits[defenderId].insert(index);
+    m_moveCount++;
     
     result.hit = isShipHit(defenderBoard, x, y);
     
@@ -105,14 +111,44 @@ std::string Game::getOpponentId(const std::string& userId) {
     return "";
 }
 
+Player Game::getPlayer(const std::string& userId) const {
+    if (userId == m_player1.id) return m_player1;
+    if (userId == m_player2.id) return m_player2;
+    return Player();
+}
+
 void Game::playerDisconnected(const std::string& userId) {
-    // Handle player disconnection - could implement game abandonment logic here
+    if (!hasPlayer(userId)) return;
+    
+    m_disconnected.insert(userId);
+    m_currentTurnId.clear();
+}
+
+bool Game::isAbandoned() const {
+    return !m_disconnected.empty();
 }
 
 std::string Game::getLobbyCode() const {
     return m_lobbyCode;
 }
 
+std::vector<Player> Game::getPlayers() const {
+    return {m_player1, m_player2};
+}
+
+int Game::getMoveCount() const {
+    return m_moveCount;
+}
+
+std::chrono::system_clock::time_point Game::getStartTime() const {
+    return m_startTime;
+}
+
+std::chrono::milliseconds Game::getElapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - m_startTick);
+}
+
 bool Game::isShipHit(const json& board, int x, int y) {
     int index = y * 10 + x;
     
@@ -9,9 +9,11 @@
 #include <vector>
 #include <map>
 #include <set>
-#include <websocketpp/connection.hpp>
+#include <chrono>
+#include <random>
 #include <nlohmann/json.hpp>
 #include "player.hpp"
+#include "instance_counter.hpp"
 
 using json = nlohmann::json;
 
@@ -32,7 +34,7 @@ struct AttackResult {
  * @class Game
  * @brief Manages game state and logic for a Battleship match between two players
  */
-class Game {
+class Game : public InstanceCounter<Game> {
 public:
     /**
      * @brief Constructor for a new game session
@@ -51,6 +53,13 @@ public:
      */
     int decideFirstPlayer();
     
+    /**
+     * @brief Determine which player goes first using the caller's generator
+     * @param gen Random generator, e.g. seeded for reproducible simulations
+     * @return Index (0 or 1) of the first player
+     */
+    int decideFirstPlayer(std::mt19937& gen);
+    
     /**
      * @brief Process an attack from a player
      * @param attackerId ID of the attacking player
@@ -74,18 +83,58 @@ public:
      */
     std::string getOpponentId(const std::string& userId);
     
+    /**
+     * @brief Get a player by ID
+     * @param userId Player ID
+     * @return Player, or a default Player if not in this game
+     */
+    Player getPlayer(const std::string& userId) const;
+    
     /**
      * @brief Handle player disconnection
+     *
+     * The game is abandoned and no further attacks are accepted.
+     *
      * @param userId ID of the disconnected player
      */
     void playerDisconnected(const std::string& userId);
     
+    /**
+     * @brief Check if a player has left the game
+     * @return True if any player disconnected before the game ended
+     */
+    bool isAbandoned() const;
+    
     /**
      * @brief Get the lobby code for this game
      * @return Lobby code string
      */
     std::string getLobbyCode() const;
     
+    /**
+     * @brief Get both players in join order
+     * @return Vector of the two players
+     */
+    std::vector<Player> getPlayers() const;
+    
+    /**
+     * @brief Get the number of attacks accepted so far
+     * @return Move count
+     */
+    int getMoveCount() const;
+    
+    /**
+     * @brief Get the wall-clock time the game was created
+     * @return Start time
+     */
+    std::chrono::system_clock::time_point getStartTime() const;
+    
+    /**
+     * @brief Get how long the game has been running
+     * @return Elapsed time since creation
+     */
+    std::chrono::milliseconds getElapsed() const;
+    
 private:
     std::string m_lobbyCode;       ///< Unique lobby identifier
     Player m_player1;              ///< First player
@@ -93,6 +142,10 @@ private:
     json m_board1;                 ///< First player's board
     json m_board2;                 ///< Second player's board
     std::string m_currentTurnId;   ///< Current player's turn
+    std::set<std::string> m_disconnected;   ///< Players who have left
+    int m_moveCount;               ///< Attacks accepted so far
+    std::chrono::system_clock::time_point m_startTime;   ///< Wall-clock start
+    std::chrono::steady_clock::time_point m_startTick;   ///< Monotonic start for durations
     
     /// Track which parts of each ship have been hit
     std::map<std::string, std::map<std::string, bool>> m_shipHits;
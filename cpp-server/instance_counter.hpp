@@ -0,0 +1,61 @@
+/**
+ * @file instance_counter.hpp
+ * @brief Live and total object counts for leak accounting
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class InstanceCounter
+ * @brief Counts live and ever-created objects of a class
+ *
+ * Derive from InstanceCounter<T> to have every T counted. Comparing the live
+ * count against the containers that should own the objects shows leaks.
+ */
+template <typename T>
+class InstanceCounter {
+public:
+    /**
+     * @brief Get number of objects currently alive
+     * @return Live object count
+     */
+    static size_t liveCount() {
+        return s_live.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get number of objects ever created
+     * @return Total object count
+     */
+    static uint64_t createdCount() {
+        return s_created.load(std::memory_order_relaxed);
+    }
+
+protected:
+    InstanceCounter() {
+        s_live.fetch_add(1, std::memory_order_relaxed);
+        s_created.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    InstanceCounter(const InstanceCounter&) : InstanceCounter() {}
+
+    InstanceCounter& operator=(const InstanceCounter&) = default;
+
+    ~InstanceCounter() {
+        s_live.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+private:
+    static std::atomic<size_t> s_live;
+    static std::atomic<uint64_t> s_created;
+};
+
+template <typename T>
+std::atomic<size_t> InstanceCounter<T>::s_live(0);
+
+template <typename T>
+std::atomic<uint64_t> InstanceCounter<T>::s_created(0);
@@ -8,13 +8,18 @@
 
 Lobby::Lobby(const std::string& code) : m_code(code) {}
 
-void Lobby::addPlayer(const Player& player) {
+bool Lobby::addPlayer(const Player& player) {
     if (hasPlayer(player.id)) {
-        return;
+        return true;
+    }
+    
+    if (m_players.size() >= kMaxPlayers) {
+        return false;
     }
     
     m_players.push_back(player);
     m_playerReady[player.id] = false;
+    return true;
 }
 
 void Lobby::removePlayer(const std::string& playerId) {
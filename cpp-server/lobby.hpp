@@ -10,6 +10,7 @@
 #include <map>
 #include <nlohmann/json.hpp>
 #include "player.hpp"
+#include "instance_counter.hpp"
 
 using json = nlohmann::json;
 
@@ -17,7 +18,7 @@ using json = nlohmann::json;
  * @class Lobby
  * @brief Manages player matchmaking and ship placement before game starts
  */
-class Lobby {
+class Lobby : public InstanceCounter<Lobby> {
 public:
     /**
      * @brief Create a new lobby with given code
@@ -28,8 +29,9 @@ public:
     /**
      * @brief Add a player to the lobby
      * @param player Player to add
+     * @return False if the lobby already holds two other players
      */
-    void addPlayer(const Player& player);
+    bool addPlayer(const Player& player);
     
     /**
      * @brief Remove a player from the lobby
@@ -83,6 +85,8 @@ public:
     json getPlayerBoard(const std::string& playerId) const;
     
 private:
+    static const size_t kMaxPlayers = 2;          ///< A lobby seats one match
+    
     std::string m_code;                           ///< Lobby identifier
     std::vector<Player> m_players;                ///< Players in lobby
     std::map<std::string, bool> m_playerReady;    ///< Ready status by player ID
@@ -0,0 +1,105 @@
+/**
+ * @file lobby_codes.cpp
+ * @brief Implementation of in-memory lobby code allocation
+ */
+
+#include "lobby_codes.hpp"
+
+namespace {
+const char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+const uint32_t kRadix = 36;
+const uint32_t kCodeSpace = kRadix * kRadix * kRadix * kRadix * kRadix * kRadix;
+}
+
+LobbyCodeAllocator::LobbyCodeAllocator(std::chrono::seconds pendingTimeout)
+    : m_pendingTimeout(pendingTimeout), m_lastSweep(clock::now()) {
+    std::random_device rd;
+    m_rng.seed(rd());
+}
+
+std::string LobbyCodeAllocator::allocate() {
+    sweepExpired();
+
+    std::uniform_int_distribution<uint32_t> distrib(0, kCodeSpace - 1);
+    uint32_t packed = distrib(m_rng);
+
+    // The code space is ~2 billion wide, so a collision is rare and a
+    // retry only costs a hash lookup
+    while (m_live.count(packed)) {
+        packed = distrib(m_rng);
+    }
+
+    m_live[packed] = Entry{false, clock::now()};
+    return decode(packed);
+}
+
+bool LobbyCodeAllocator::claim(const std::string& code) {
+    uint32_t packed;
+    if (!encode(code, packed)) {
+        return false;
+    }
+
+    m_live[packed] = Entry{true, clock::now()};
+    return true;
+}
+
+void LobbyCodeAllocator::release(const std::string& code) {
+    uint32_t packed;
+    if (encode(code, packed)) {
+        m_live.erase(packed);
+    }
+}
+
+bool LobbyCodeAllocator::isLive(const std::string& code) const {
+    uint32_t packed;
+    return encode(code, packed) && m_live.count(packed) > 0;
+}
+
+size_t LobbyCodeAllocator::liveCount() const {
+    return m_live.size();
+}
+
+void LobbyCodeAllocator::sweepExpired() {
+    clock::time_point now = clock::now();
+    if (now - m_lastSweep < std::chrono::seconds(60)) {
+        return;
+    }
+    m_lastSweep = now;
+
+    for (auto it = m_live.begin(); it != m_live.end();) {
+        if (!it->second.claimed && now - it->second.allocatedAt > m_pendingTimeout) {
+            it = m_live.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool LobbyCodeAllocator::encode(const std::string& code, uint32_t& packed) {
+    if (code.size() != kCodeLength) {
+        return false;
+    }
+
+    packed = 0;
+    for (char c : code) {
+        uint32_t digit;
+        if (c >= 'A' && c <= 'Z') {
+            digit = c - 'A';
+        } else if (c >= '0' && c <= '9') {
+            digit = 26 + (c - '0');
+        } else {
+            return false;
+        }
+        packed = packed * kRadix + digit;
+    }
+    return true;
+}
+
+std::string LobbyCodeAllocator::decode(uint32_t packed) {
+    std::string code(kCodeLength, 'A');
+    for (size_t i = kCodeLength; i > 0; --i) {
+        code[i - 1] = kAlphabet[packed % kRadix];
+        packed /= kRadix;
+    }
+    return code;
+}
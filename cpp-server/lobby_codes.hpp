@@ -0,0 +1,98 @@
+/**
+ * @file lobby_codes.hpp
+ * @brief In-memory allocation of unique lobby codes
+ */
+
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @class LobbyCodeAllocator
+ * @brief Hands out unique 6-character lobby codes and tracks which are live
+ *
+ * Codes use uppercase letters and digits, matching the format the Django
+ * backend has always issued. Each code is packed into a 32-bit integer
+ * (36^6 < 2^32) so the live set is a compact hash of integers. Allocated
+ * codes that are never claimed by a joining player expire after a timeout.
+ */
+class LobbyCodeAllocator {
+public:
+    static const size_t kCodeLength = 6;   ///< Characters per lobby code
+
+    /**
+     * @brief Create an allocator
+     * @param pendingTimeout How long an unclaimed code stays reserved
+     */
+    explicit LobbyCodeAllocator(std::chrono::seconds pendingTimeout = std::chrono::minutes(10));
+
+    /**
+     * @brief Allocate a fresh code that is not currently live
+     * @return New lobby code
+     */
+    std::string allocate();
+
+    /**
+     * @brief Mark a code as in use by a lobby
+     * @param code Lobby code, either allocated here or issued elsewhere
+     * @return False if the code is malformed, true otherwise
+     */
+    bool claim(const std::string& code);
+
+    /**
+     * @brief Return a code to the free pool
+     * @param code Lobby code to release
+     */
+    void release(const std::string& code);
+
+    /**
+     * @brief Check whether a code is allocated or claimed
+     * @param code Lobby code to check
+     * @return True if the code is live
+     */
+    bool isLive(const std::string& code) const;
+
+    /**
+     * @brief Get number of live codes
+     * @return Count of allocated and claimed codes
+     */
+    size_t liveCount() const;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    /// Live codes mapped to their allocation time; claimed codes never expire
+    struct Entry {
+        bool claimed;
+        clock::time_point allocatedAt;
+    };
+
+    std::unordered_map<uint32_t, Entry> m_live;   ///< Live codes by packed value
+    std::chrono::seconds m_pendingTimeout;        ///< Expiry for unclaimed codes
+    clock::time_point m_lastSweep;                ///< Last expiry sweep
+    std::mt19937 m_rng;                           ///< Code generator
+
+    /**
+     * @brief Drop unclaimed codes older than the pending timeout
+     */
+    void sweepExpired();
+
+    /**
+     * @brief Pack a code into an integer
+     * @param code Lobby code
+     * @param packed Output value
+     * @return False if the code is not 6 uppercase letters or digits
+     */
+    static bool encode(const std::string& code, uint32_t& packed);
+
+    /**
+     * @brief Unpack an integer into a code
+     * @param packed Packed value
+     * @return Lobby code
+     */
+    static std::string decode(uint32_t packed);
+};
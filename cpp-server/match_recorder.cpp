@@ -0,0 +1,312 @@
+/**
+ * @file match_recorder.cpp
+ * @brief Implementation of asynchronous match result recording
+ */
+
+#include "match_recorder.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+#include <algorithm>
+#include <boost/asio/ip/tcp.hpp>
+
+json MatchResult::toJson() const {
+    return {
+        {"lobby", lobbyCode},
+        {"players", {
+            {{"id", player1Id}, {"username", player1Name}},
+            {{"id", player2Id}, {"username", player2Name}}
+        }},
+        {"winner", winnerId},
+        {"outcome", outcome},
+        {"moves", moves},
+        {"started_at", startedAt},
+        {"duration_ms", durationMs}
+    };
+}
+
+FileMatchSink::FileMatchSink(const std::string& path) : m_path(path) {}
+
+WriteStatus FileMatchSink::write(const std::vector<json>& batch) {
+    std::ofstream out(m_path, std::ios::app);
+    for (const json& doc : batch) {
+        out << doc.dump() << '\n';
+    }
+    out.flush();
+    return out ? WriteStatus::Stored : WriteStatus::Retry;
+}
+
+HttpMatchSink::HttpMatchSink(const std::string& host, const std::string& port,
+                             const std::string& path, const std::string& token)
+    : m_host(host), m_port(port), m_path(path), m_token(token) {}
+
+WriteStatus HttpMatchSink::write(const std::vector<json>& batch) {
+    boost::asio::ip::tcp::iostream stream;
+    stream.expires_after(std::chrono::seconds(5));
+    stream.connect(m_host, m_port);
+    if (!stream) {
+        return WriteStatus::Retry;
+    }
+
+    std::string body = json(batch).dump();
+    stream << "POST " << m_path << " HTTP/1.1\r\n"
+           << "Host: " << m_host << "\r\n"
+           << "Content-Type: application/json\r\n"
+           << "Content-Length: " << body.size() << "\r\n";
+    if (!m_token.empty()) {
+        stream << "X-Internal-Token: " << m_token << "\r\n";
+    }
+    stream << "Connection: close\r\n\r\n" << body << std::flush;
+
+    std::string httpVersion;
+    int status = 0;
+    stream >> httpVersion >> status;
+
+    if (!stream) {
+        return WriteStatus::Retry;
+    }
+    if (status >= 200 && status < 300) {
+        return WriteStatus::Stored;
+    }
+    // Timeouts and rate limiting are worth retrying; any other client error is final
+    if (status >= 400 && status < 500 && status != 408 && status != 429) {
+        std::cerr << "Backend rejected " << batch.size() << " match results with HTTP " << status << std::endl;
+        return WriteStatus::Rejected;
+    }
+    return WriteStatus::Retry;
+}
+
+std::unique_ptr<MatchSink> makeMatchSink(const std::string& target, const std::string& token) {
+    const std::string filePrefix = "file:";
+    const std::string httpPrefix = "http://";
+
+    if (target.compare(0, filePrefix.size(), filePrefix) == 0) {
+        return std::unique_ptr<MatchSink>(new FileMatchSink(target.substr(filePrefix.size())));
+    }
+
+    if (target.compare(0, httpPrefix.size(), httpPrefix) == 0) {
+        std::string rest = target.substr(httpPrefix.size());
+        size_t slash = rest.find('/');
+        std::string hostPort = rest.substr(0, slash);
+        std::string path = (slash == std::string::npos) ? "/" : rest.substr(slash);
+
+        size_t colon = hostPort.find(':');
+        std::string host = hostPort.substr(0, colon);
+        std::string port = (colon == std::string::npos) ? "80" : hostPort.substr(colon + 1);
+
+        return std::unique_ptr<MatchSink>(new HttpMatchSink(host, port, path, token));
+    }
+
+    return nullptr;
+}
+
+MatchRecorder::MatchRecorder(std::unique_ptr<MatchSink> sink, const std::string& spillPath,
+                             size_t maxSpillBytes, std::chrono::milliseconds replayInterval)
+    : m_sink(std::move(sink)), m_spillPath(spillPath), m_quarantinePath(spillPath + ".rejected"),
+      m_maxSpillBytes(maxSpillBytes), m_replayInterval(replayInterval), m_spillBytes(0),
+      m_quarantineBytes(0), m_nextReplay(), m_queue(kQueueCapacity), m_stopping(false),
+      m_queued(0), m_written(0), m_spilled(0), m_rejected(0), m_dropped(0) {
+
+    // Pick up batches left behind by a previous run
+    std::ifstream in(m_spillPath);
+    std::string line;
+    while (std::getline(in, line)) {
+        m_spillBytes += line.size() + 1;
+        m_spilled++;
+    }
+
+    std::ifstream quarantined(m_quarantinePath, std::ios::binary | std::ios::ate);
+    if (quarantined) {
+        m_quarantineBytes = static_cast<size_t>(quarantined.tellg());
+    }
+
+    m_writer = std::thread(&MatchRecorder::run, this);
+}
+
+MatchRecorder::~MatchRecorder() {
+    m_stopping = true;
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+}
+
+bool MatchRecorder::record(MatchResult result) {
+    if (!m_queue.tryPush(std::move(result))) {
+        m_dropped++;
+        return false;
+    }
+
+    m_queued++;
+    return true;
+}
+
+json MatchRecorder::getStats() const {
+    return {
+        {"queued", m_queued.load()},
+        {"written", m_written.load()},
+        {"spilled", m_spilled.load()},
+        {"rejected", m_rejected.load()},
+        {"dropped", m_dropped.load()}
+    };
+}
+
+void MatchRecorder::run() {
+    while (!m_stopping) {
+        flush();
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+
+    flush();
+}
+
+void MatchRecorder::flush() {
+    bool spillClear = (m_spilled == 0) || replaySpill();
+
+    std::vector<json> batch;
+    MatchResult result;
+    while (true) {
+        batch.clear();
+        while (batch.size() < kBatchSize && m_queue.tryPop(result)) {
+            batch.push_back(result.toJson());
+        }
+        if (batch.empty()) {
+            break;
+        }
+
+        // Keep results in order: while older batches are spilled, new ones join them
+        if (spillClear) {
+            WriteStatus status = writeWithRetry(batch);
+            if (status == WriteStatus::Stored) {
+                m_written += batch.size();
+                continue;
+            }
+            if (status == WriteStatus::Rejected) {
+                quarantine(batch);
+                continue;
+            }
+        }
+        spillClear = false;
+        spill(batch);
+    }
+}
+
+WriteStatus MatchRecorder::writeWithRetry(const std::vector<json>& batch) {
+    std::chrono::milliseconds backoff(100);
+
+    for (int attempt = 1; attempt <= kMaxAttempts; ++attempt) {
+        WriteStatus status = m_sink->write(batch);
+        if (status != WriteStatus::Retry) {
+            return status;
+        }
+        if (attempt < kMaxAttempts) {
+            std::this_thread::sleep_for(backoff);
+            backoff *= 2;
+        }
+    }
+
+    std::cerr << "Failed to write " << batch.size() << " match results" << std::endl;
+    return WriteStatus::Retry;
+}
+
+bool MatchRecorder::replaySpill() {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now < m_nextReplay) {
+        return false;
+    }
+
+    std::vector<json> pending;
+    {
+        std::ifstream in(m_spillPath);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            try {
+                pending.push_back(json::parse(line));
+            } catch (const std::exception& e) {
+                std::cerr << "Discarding corrupt spilled match result: " << e.what() << std::endl;
+            }
+        }
+    }
+
+    size_t done = 0;
+    while (done < pending.size()) {
+        size_t end = std::min(done + kBatchSize, pending.size());
+        std::vector<json> batch(pending.begin() + done, pending.begin() + end);
+        WriteStatus status = m_sink->write(batch);
+        if (status == WriteStatus::Retry) {
+            break;
+        }
+        if (status == WriteStatus::Stored) {
+            m_written += batch.size();
+        } else {
+            quarantine(batch);
+        }
+        done = end;
+    }
+
+    if (done == pending.size()) {
+        std::remove(m_spillPath.c_str());
+        m_spillBytes = 0;
+        m_spilled = 0;
+        return true;
+    }
+
+    m_nextReplay = now + m_replayInterval;
+    if (done == 0) {
+        return false;
+    }
+
+    // Rewrite the spill file with only the documents still outstanding
+    std::ofstream out(m_spillPath, std::ios::trunc);
+    m_spillBytes = 0;
+    for (size_t i = done; i < pending.size(); ++i) {
+        std::string line = pending[i].dump();
+        out << line << '\n';
+        m_spillBytes += line.size() + 1;
+    }
+    m_spilled = pending.size() - done;
+    return false;
+}
+
+void MatchRecorder::spill(const std::vector<json>& batch) {
+    if (!appendCapped(m_spillPath, batch, m_spillBytes)) {
+        std::cerr << "Could not spill, dropping " << batch.size() << " match results" << std::endl;
+        m_dropped += batch.size();
+        return;
+    }
+
+    m_spilled += batch.size();
+}
+
+void MatchRecorder::quarantine(const std::vector<json>& batch) {
+    if (!appendCapped(m_quarantinePath, batch, m_quarantineBytes)) {
+        std::cerr << "Could not quarantine, dropping " << batch.size() << " rejected match results" << std::endl;
+        m_dropped += batch.size();
+        return;
+    }
+
+    std::cerr << "Quarantined " << batch.size() << " rejected match results in " << m_quarantinePath << std::endl;
+    m_rejected += batch.size();
+}
+
+bool MatchRecorder::appendCapped(const std::string& path, const std::vector<json>& batch, size_t& fileBytes) {
+    std::string lines;
+    for (const json& doc : batch) {
+        lines += doc.dump();
+        lines += '\n';
+    }
+
+    if (fileBytes + lines.size() > m_maxSpillBytes) {
+        return false;
+    }
+
+    std::ofstream out(path, std::ios::app);
+    out << lines;
+    out.flush();
+    if (!out) {
+        return false;
+    }
+
+    fileBytes += lines.size();
+    return true;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file match_recorder.hpp
+ * @brief Asynchronous recording of finished matches to a backing store
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "spsc_queue.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @struct MatchResult
+ * @brief Summary of a finished match
+ */
+struct MatchResult {
+    std::string lobbyCode;     ///< Lobby the match was played in
+    std::string player1Id;     ///< First player's ID
+    std::string player1Name;   ///< First player's display name
+    std::string player2Id;     ///< Second player's ID
+    std::string player2Name;   ///< Second player's display name
+    std::string winnerId;      ///< ID of the winning player
+    std::string outcome;       ///< "completed", or "abandoned" if a player left
+    int moves;                 ///< Number of accepted attacks
+    int64_t startedAt;         ///< Match start as milliseconds since the epoch
+    int64_t durationMs;        ///< Match length in milliseconds
+
+    /**
+     * @brief Serialize for storage
+     * @return JSON document describing the match
+     */
+    json toJson() const;
+};
+
+/**
+ * @enum WriteStatus
+ * @brief Outcome of handing a batch to a sink
+ */
+enum class WriteStatus {
+    Stored,     ///< The whole batch was stored
+    Retry,      ///< The sink is unavailable; the batch may succeed later
+    Rejected    ///< The sink refused the batch and will keep refusing it
+};
+
+/**
+ * @class MatchSink
+ * @brief Destination that stores batches of match documents
+ */
+class MatchSink {
+public:
+    virtual ~MatchSink() = default;
+
+    /**
+     * @brief Store a batch of match documents
+     * @param batch Documents to store
+     * @return Whether the batch was stored, or why not
+     */
+    virtual WriteStatus write(const std::vector<json>& batch) = 0;
+};
+
+/**
+ * @class FileMatchSink
+ * @brief Appends match documents to a local file, one JSON object per line
+ */
+class FileMatchSink : public MatchSink {
+public:
+    explicit FileMatchSink(const std::string& path);
+    WriteStatus write(const std::vector<json>& batch) override;
+
+private:
+    std::string m_path;   ///< Output file
+};
+
+/**
+ * @class HttpMatchSink
+ * @brief Posts match documents to the Django backend, which stores them in MongoDB
+ *
+ * A 4xx answer other than 408 or 429 means the backend will never accept the
+ * batch (a malformed document, or a body over its upload limit), so it is
+ * reported as rejected rather than retried.
+ */
+class HttpMatchSink : public MatchSink {
+public:
+    /**
+     * @brief Create a sink for an HTTP endpoint
+     * @param host Backend host name
+     * @param port Backend port
+     * @param path Endpoint path
+     * @param token Shared secret sent as X-Internal-Token, may be empty
+     */
+    HttpMatchSink(const std::string& host, const std::string& port,
+                  const std::string& path, const std::string& token);
+    WriteStatus write(const std::vector<json>& batch) override;
+
+private:
+    std::string m_host;
+    std::string m_port;
+    std::string m_path;
+    std::string m_token;
+};
+
+/**
+ * @brief Build a sink from a target description
+ * @param target Either "file:<path>" or "http://host[:port]/path"
+ * @param token Shared secret for HTTP targets
+ * @return Sink, or nullptr if the target is not recognised
+ */
+std::unique_ptr<MatchSink> makeMatchSink(const std::string& target, const std::string& token);
+
+/**
+ * @class MatchRecorder
+ * @brief Queues match results and writes them in batches on a background thread
+ *
+ * record() is called from the server's io thread and never blocks: results
+ * go onto a lock-free queue and are dropped if it is full. The writer thread
+ * retries failed batches and then spills them to a size-capped file, which
+ * is replayed ahead of new batches once the sink recovers. Batches the sink
+ * rejects outright are moved to a quarantine file next to the spill file
+ * (spill path + ".rejected") so they cannot hold up later results.
+ */
+class MatchRecorder {
+public:
+    /**
+     * @brief Start the writer thread
+     * @param sink Destination for match documents
+     * @param spillPath File that holds batches the sink rejected
+     * @param maxSpillBytes Size cap for the spill file
+     * @param replayInterval Wait after a failed replay before trying again
+     */
+    MatchRecorder(std::unique_ptr<MatchSink> sink, const std::string& spillPath,
+                  size_t maxSpillBytes = 16 * 1024 * 1024,
+                  std::chrono::milliseconds replayInterval = std::chrono::seconds(5));
+
+    /**
+     * @brief Flush pending results and stop the writer thread
+     */
+    ~MatchRecorder();
+
+    MatchRecorder(const MatchRecorder&) = delete;
+    MatchRecorder& operator=(const MatchRecorder&) = delete;
+
+    /**
+     * @brief Queue a result for writing (single producer thread only)
+     * @param result Finished match
+     * @return False if the queue was full and the result was dropped
+     */
+    bool record(MatchResult result);
+
+    /**
+     * @brief Get counters describing the recorder's progress
+     * @return JSON object with queued, written, spilled, rejected and dropped counts
+     */
+    json getStats() const;
+
+private:
+    static const size_t kQueueCapacity = 4096;
+    static const size_t kBatchSize = 256;
+    static const int kMaxAttempts = 3;
+
+    std::unique_ptr<MatchSink> m_sink;
+    std::string m_spillPath;
+    std::string m_quarantinePath;                 ///< Batches the sink rejected
+    size_t m_maxSpillBytes;
+    std::chrono::milliseconds m_replayInterval;
+    size_t m_spillBytes;                          ///< Spill file size, writer thread only
+    size_t m_quarantineBytes;                     ///< Quarantine file size, writer thread only
+    std::chrono::steady_clock::time_point m_nextReplay;   ///< Earliest next replay attempt
+    SpscQueue<MatchResult> m_queue;
+    std::atomic<bool> m_stopping;
+    std::thread m_writer;
+
+    std::atomic<uint64_t> m_queued;    ///< Results accepted by record()
+    std::atomic<uint64_t> m_written;   ///< Results stored by the sink
+    std::atomic<uint64_t> m_spilled;   ///< Results currently parked in the spill file
+    std::atomic<uint64_t> m_rejected;  ///< Results the sink refused, moved to quarantine
+    std::atomic<uint64_t> m_dropped;   ///< Results lost to a full queue or a full spill or quarantine file
+
+    /**
+     * @brief Writer thread main loop
+     */
+    void run();
+
+    /**
+     * @brief Drain the queue and write everything it held
+     */
+    void flush();
+
+    /**
+     * @brief Write a batch, retrying with backoff while the sink is unavailable
+     * @param batch Documents to write
+     * @return Stored, Rejected, or Retry once the attempts run out
+     */
+    WriteStatus writeWithRetry(const std::vector<json>& batch);
+
+    /**
+     * @brief Resend spilled batches once the sink is reachable
+     * @return True if the spill file is now empty
+     */
+    bool replaySpill();
+
+    /**
+     * @brief Park a rejected batch in the spill file
+     * @param batch Documents that could not be written
+     */
+    void spill(const std::vector<json>& batch);
+
+    /**
+     * @brief Set aside a batch the sink rejected
+     * @param batch Documents that will never be accepted
+     */
+    void quarantine(const std::vector<json>& batch);
+
+    /**
+     * @brief Append documents to a size-capped JSON-lines file
+     * @param path File to append to
+     * @param batch Documents to append
+     * @param fileBytes Current size of the file, updated on success
+     * @return False if the cap would be exceeded or the write failed
+     */
+    bool appendCapped(const std::string& path, const std::vector<json>& batch, size_t& fileBytes);
+};
@@ -6,7 +6,7 @@
 #pragma once
 
 #include <string>
-#include <websocketpp/connection.hpp>
+#include <websocketpp/common/connection_hdl.hpp>
 
 typedef websocketpp::connection_hdl connection_hdl;
 
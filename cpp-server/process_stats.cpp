@@ -0,0 +1,20 @@
+/**
+ * @file process_stats.cpp
+ * @brief Implementation of process-level resource readings
+ */
+
+#include "process_stats.hpp"
+#include <fstream>
+#include <unistd.h>
+
+size_t getResidentBytes() {
+    // /proc/self/statm reports sizes in pages: total, then resident
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) {
+        return 0;
+    }
+
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
@@ -0,0 +1,14 @@
+/**
+ * @file process_stats.hpp
+ * @brief Process-level resource readings for server diagnostics
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Get the resident set size of the current process
+ * @return RSS in bytes, or 0 if it cannot be read on this platform
+ */
+size_t getResidentBytes();
@@ -0,0 +1,56 @@
+/**
+ * @file server_config.hpp
+ * @brief websocketpp configuration profiles for the Battleship server
+ */
+
+#pragma once
+
+#include <websocketpp/config/asio_no_tls.hpp>
+#include <websocketpp/concurrency/none.hpp>
+#include <websocketpp/logger/basic.hpp>
+
+/**
+ * @struct density_config
+ * @brief Config tuned for holding many idle connections on one box
+ *
+ * Most sockets belong to players waiting in a lobby, so per-connection
+ * memory rather than CPU limits how many the server can hold. Compared with
+ * the stock asio config this profile:
+ *  - shrinks the read buffer embedded in every connection from 16 KB to 1 KB;
+ *    game messages are a few hundred bytes and larger frames still arrive
+ *    over several reads
+ *  - caps message and HTTP body sizes at what the protocol needs
+ *  - drops per-connection mutexes and asio strands, since the server runs
+ *    everything on a single io thread
+ *
+ * Target: 1M idle connections per box. Measure with tools/idle_connections.py.
+ */
+struct density_config : public websocketpp::config::asio {
+    typedef density_config type;
+    typedef websocketpp::config::asio base;
+
+    typedef websocketpp::concurrency::none concurrency_type;
+
+    typedef websocketpp::log::basic<concurrency_type,
+        websocketpp::log::elevel> elog_type;
+    typedef websocketpp::log::basic<concurrency_type,
+        websocketpp::log::alevel> alog_type;
+
+    static const size_t connection_read_buffer_size = 1024;
+    static const size_t max_message_size = 64 * 1024;
+    static const size_t max_http_body_size = 4 * 1024;
+    static const bool enable_multithreading = false;
+
+    struct transport_config : public base::transport_config {
+        typedef type::concurrency_type concurrency_type;
+        typedef type::alog_type alog_type;
+        typedef type::elog_type elog_type;
+        typedef type::request_type request_type;
+        typedef type::response_type response_type;
+        typedef websocketpp::transport::asio::basic_socket::endpoint socket_type;
+
+        static const bool enable_multithreading = false;
+    };
+
+    typedef websocketpp::transport::asio::endpoint<transport_config> transport_type;
+};
@@ -0,0 +1,363 @@
+/**
+ * @file session_manager.cpp
+ * @brief Implementation of lobby and game session handling
+ */
+
+#include "session_manager.hpp"
+#include <iostream>
+#include "trace.hpp"
+
+SessionManager::SessionManager(SendFunction send, MatchRecorder* matchRecorder)
+    : m_send(std::move(send)), m_matchRecorder(matchRecorder) {}
+
+std::string SessionManager::allocateLobbyCode() {
+    return m_lobbyCodes.allocate();
+}
+
+void SessionManager::handleMessage(connection_hdl hdl, const json& data) {
+    std::string messageType = data.value("type", "");
+    
+    if (messageType == "join") {
+        handleJoinMessage(hdl, data);
+    }
+    else if (messageType == "ready") {
+        handleReadyMessage(hdl, data);
+    }
+    else if (messageType == "attack") {
+        handleAttackMessage(hdl, data);
+    }
+    else if (messageType == "leave") {
+        handleLeaveMessage(hdl, data);
+    }
+    else {
+        std::cout << "Unknown message type: " << messageType << std::endl;
+    }
+}
+
+void SessionManager::closeConnection(connection_hdl hdl) {
+    auto it = m_connections.find(hdl);
+    if (it == m_connections.end()) return;
+    
+    // leaveChannel edits the channel map, so walk a copy
+    std::map<std::string, std::string> channels = it->second.channels;
+    for (const auto& channel : channels) {
+        // Tag each channel's departure notices with its own lobby
+        TraceSpan::setLobby(channel.first);
+        leaveChannel(hdl, channel.first, channel.second);
+    }
+    TraceSpan::setLobby("");
+    
+    m_connections.erase(it);
+}
+
+json SessionManager::getStats() const {
+    return {
+        {"players", m_connections.size()},
+        {"lobbies", m_lobbies.size()},
+        {"games", m_games.size()},
+        {"liveLobbyCodes", m_lobbyCodes.liveCount()},
+        {"liveObjects", {
+            {"lobbies", Lobby::liveCount()},
+            {"games", Game::liveCount()}
+        }},
+        {"createdObjects", {
+            {"lobbies", Lobby::createdCount()},
+            {"games", Game::createdCount()}
+        }}
+    };
+}
+
+void SessionManager::handleJoinMessage(connection_hdl hdl, const json& data) {
+    std::string lobbyCode = data.value("lobby", "");
+    std::string userId = data.value("user", "");
+    std::string username = data.value("username", "");
+    
+    std::cout << "Player " << username << " (ID: " << userId << ") joining lobby " << lobbyCode << std::endl;
+    
+    // Channels are keyed by lobby, so one connection can only play one side of a game
+    auto conn_it = m_connections.find(hdl);
+    if (conn_it != m_connections.end()) {
+        auto channel_it = conn_it->second.channels.find(lobbyCode);
+        if (channel_it != conn_it->second.channels.end() && channel_it->second != userId) {
+            rejectJoin(hdl, lobbyCode, "Connection already joined this lobby as another user");
+            return;
+        }
+    }
+    
+    if (m_games.find(lobbyCode) != m_games.end()) {
+        rejectJoin(hdl, lobbyCode, "Game already in progress");
+        return;
+    }
+    
+    if (m_lobbies.find(lobbyCode) == m_lobbies.end()) {
+        m_lobbies[lobbyCode] = std::make_unique<Lobby>(lobbyCode);
+        m_lobbyCodes.claim(lobbyCode);
+    }
+    
+    Lobby& lobby = *m_lobbies[lobbyCode];
+    Player player{userId, username, hdl};
+    if (!lobby.addPlayer(player)) {
+        rejectJoin(hdl, lobbyCode, "Lobby is full");
+        return;
+    }
+    
+    m_connections[hdl].channels[lobbyCode] = userId;
+    
+    if (lobby.getPlayerCount() == 2) {
+        Player firstPlayer = lobby.getPlayers()[0];
+        json notification = {
+            {"type", "opponentJoined"},
+            {"username", username}
+        };
+        sendToChannel(firstPlayer.hdl, lobbyCode, notification);
+    }
+    
+    json confirmation = {
+        {"type", "joinConfirmed"},
+        {"message", "Successfully joined lobby " + lobbyCode}
+    };
+    sendToChannel(hdl, lobbyCode, confirmation);
+}
+
+void SessionManager::rejectJoin(connection_hdl hdl, const std::string& lobbyCode, const std::string& reason) {
+    std::cout << "Join of lobby " << lobbyCode << " rejected: " << reason << std::endl;
+    json rejection = {
+        {"type", "joinRejected"},
+        {"message", reason}
+    };
+    sendToChannel(hdl, lobbyCode, rejection);
+}
+
+void SessionManager::handleReadyMessage(connection_hdl hdl, const json& data) {
+    std::string lobbyCode;
+    std::string userId;
+    if (!resolveChannel(hdl, data, lobbyCode, userId)) {
+        std::cerr << "Ready message for a lobby this connection has not joined" << std::endl;
+        return;
+    }
+    
+    json board = data.value("board", json::object());
+    
+    std::cout << "Player " << userId << " is ready with " << board.size() << " ships" << std::endl;
+    
+    auto lobby_it = m_lobbies.find(lobbyCode);
+    if (lobby_it == m_lobbies.end()) return;
+    
+    Lobby& lobby = *lobby_it->second;
+    std::cout << "Found player in lobby " << lobby.getLobbyCode() << std::endl;
+    
+    lobby.setPlayerReady(userId, board);
+    
+    std::cout << "Player count: " << lobby.getPlayerCount() 
+             << ", All ready: " << lobby.areAllPlayersReady() << std::endl;
+    
+    if (lobby.areAllPlayersReady()) {
+        std::cout << "Starting game for lobby " << lobby.getLobbyCode() << std::endl;
+        startGame(lobby);
+    } else {
+        std::cout << "Not all players ready yet" << std::endl;
+    }
+}
+
+void SessionManager::handleAttackMessage(connection_hdl hdl, const json& data) {
+    std::string lobbyCode;
+    std::string userId;
+    if (!resolveChannel(hdl, data, lobbyCode, userId)) {
+        std::cerr << "Attack message for a lobby this connection has not joined" << std::endl;
+        return;
+    }
+    
+    int x = data.value("x", -1);
+    int y = data.value("y", -1);
+    
+    if (x < 0 || y < 0 || x >= 10 || y >= 10) {
+        std::cerr << "Invalid attack coordinates: " << x << "," << y << std::endl;
+        return;
+    }
+    
+    auto game_it = m_games.find(lobbyCode);
+    if (game_it == m_games.end() || !game_it->second->hasPlayer(userId)) return;
+    
+    Game& game = *game_it->second;
+    AttackResult result = game.processAttack(userId, x, y);
+    
+    json attackerMsg = {
+        {"type", "attackResult"},
+        {"x", x},
+        {"y", y},
+        {"hit", result.hit},
+        {"sunk", result.shipSunk},
+        {"nextPlayer", result.nextPlayerId},
+        {"gameOver", result.gameOver},
+        {"winner", result.winnerId}
+    };
+    sendToChannel(hdl, lobbyCode, attackerMsg);
+    
+    Player defender = game.getPlayer(game.getOpponentId(userId));
+    
+    json defenderMsg = {
+        {"type", "attacked"},
+        {"x", x},
+        {"y", y},
+        {"hit", result.hit},
+        {"sunk", result.shipSunk},
+        {"nextPlayer", result.nextPlayerId},
+        {"gameOver", result.gameOver},
+        {"winner", result.winnerId}
+    };
+    sendToChannel(defender.hdl, lobbyCode, defenderMsg);
+    
+    if (result.gameOver) {
+        json gameOverMsg = {
+            {"type", "gameOver"},
+            {"winner", result.winnerId}
+        };
+        
+        sendToChannel(hdl, lobbyCode, gameOverMsg);
+        sendToChannel(defender.hdl, lobbyCode, gameOverMsg);
+        
+        recordMatch(game, result.winnerId);
+        
+        closeChannel(hdl, lobbyCode);
+        closeChannel(defender.hdl, lobbyCode);
+        m_games.erase(game_it);
+        m_lobbyCodes.release(lobbyCode);
+    }
+}
+
+void SessionManager::handleLeaveMessage(connection_hdl hdl, const json& data) {
+    std::string lobbyCode;
+    std::string userId;
+    if (resolveChannel(hdl, data, lobbyCode, userId)) {
+        leaveChannel(hdl, lobbyCode, userId);
+    }
+}
+
+void SessionManager::startGame(Lobby& lobby) {
+    std::string lobbyCode = lobby.getLobbyCode();
+    std::vector<Player> players = lobby.getPlayers();
+    
+    std::cout << "Starting game with " << players.size() << " players in lobby " << lobbyCode << std::endl;
+    
+    if (players.size() != 2) {
+        std::cerr << "Cannot start game without exactly 2 players" << std::endl;
+        return;
+    }
+    
+    m_games[lobbyCode] = std::make_unique<Game>(lobbyCode, players[0], players[1], 
+        lobby.getPlayerBoard(players[0].id), lobby.getPlayerBoard(players[1].id));
+    
+    Game& game = *m_games[lobbyCode];
+    int firstPlayerIdx = game.decideFirstPlayer();
+    std::string firstPlayerId = players[firstPlayerIdx].id;
+    
+    std::cout << "First player: " << firstPlayerId << " (index " << firstPlayerIdx << ")" << std::endl;
+    
+    for (const Player& player : players) {
+        json startMsg = {
+            {"type", "gameStart"},
+            {"firstPlayer", firstPlayerId}
+        };
+        std::cout << "Sending gameStart message to player " << player.id << std::endl;
+        sendToChannel(player.hdl, lobbyCode, startMsg);
+    }
+    
+    m_lobbies.erase(lobbyCode);
+    std::cout << "Game started successfully, lobby removed" << std::endl;
+}
+
+void SessionManager::recordMatch(const Game& game, const std::string& winnerId) {
+    if (!m_matchRecorder) return;
+    
+    std::vector<Player> players = game.getPlayers();
+    MatchResult result;
+    result.lobbyCode = game.getLobbyCode();
+    result.player1Id = players[0].id;
+    result.player1Name = players[0].username;
+    result.player2Id = players[1].id;
+    result.player2Name = players[1].username;
+    result.winnerId = winnerId;
+    result.outcome = game.isAbandoned() ? "abandoned" : "completed";
+    result.moves = game.getMoveCount();
+    result.startedAt = std::chrono::duration_cast<std::chrono::milliseconds>(
+        game.getStartTime().time_since_epoch()).count();
+    result.durationMs = game.getElapsed().count();
+    
+    if (!m_matchRecorder->record(std::move(result))) {
+        std::cerr << "Match recorder queue full, dropped result for lobby " << game.getLobbyCode() << std::endl;
+    }
+}
+
+void SessionManager::notifyLobbyUpdate(const Lobby& lobby) {
+    // Future implementation for lobby updates
+}
+
+bool SessionManager::resolveChannel(connection_hdl hdl, const json& data, std::string& lobbyCode, std::string& userId) {
+    auto conn_it = m_connections.find(hdl);
+    if (conn_it == m_connections.end()) return false;
+    
+    const std::map<std::string, std::string>& channels = conn_it->second.channels;
+    lobbyCode = data.value("lobby", "");
+    if (lobbyCode.empty() && channels.size() == 1) {
+        lobbyCode = channels.begin()->first;
+    }
+    
+    auto channel_it = channels.find(lobbyCode);
+    if (channel_it == channels.end()) return false;
+    
+    userId = channel_it->second;
+    TraceSpan::setLobby(lobbyCode);
+    return true;
+}
+
+void SessionManager::leaveChannel(connection_hdl hdl, const std::string& lobbyCode, const std::string& userId) {
+    closeChannel(hdl, lobbyCode);
+    
+    auto lobby_it = m_lobbies.find(lobbyCode);
+    if (lobby_it != m_lobbies.end()) {
+        Lobby& lobby = *lobby_it->second;
+        lobby.removePlayer(userId);
+        if (lobby.getPlayerCount() == 0) {
+            m_lobbyCodes.release(lobbyCode);
+            m_lobbies.erase(lobby_it);
+        } else {
+            notifyLobbyUpdate(lobby);
+        }
+        return;
+    }
+    
+    auto game_it = m_games.find(lobbyCode);
+    if (game_it != m_games.end() && game_it->second->hasPlayer(userId)) {
+        Game& game = *game_it->second;
+        game.playerDisconnected(userId);
+        
+        std::string opponentId = game.getOpponentId(userId);
+        recordMatch(game, opponentId);
+        
+        Player opponent = game.getPlayer(opponentId);
+        if (opponent.hdl.lock()) {
+            json msg = {
+                {"type", "opponentDisconnected"},
+                {"message", "Your opponent has disconnected from the game."}
+            };
+            sendToChannel(opponent.hdl, lobbyCode, msg);
+        }
+        closeChannel(opponent.hdl, lobbyCode);
+        
+        // An abandoned game can never finish, so drop it now
+        m_lobbyCodes.release(lobbyCode);
+        m_games.erase(game_it);
+    }
+}
+
+void SessionManager::closeChannel(connection_hdl hdl, const std::string& lobbyCode) {
+    auto conn_it = m_connections.find(hdl);
+    if (conn_it != m_connections.end()) {
+        conn_it->second.channels.erase(lobbyCode);
+    }
+}
+
+void SessionManager::sendToChannel(connection_hdl hdl, const std::string& lobbyCode, json data) {
+    data["lobby"] = lobbyCode;
+    m_send(hdl, data);
+}
@@ -0,0 +1,172 @@
+/**
+ * @file session_manager.hpp
+ * @brief Lobby and game sessions behind the WebSocket server
+ */
+
+#pragma once
+
+#include <string>
+#include <map>
+#include <memory>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include "game.hpp"
+#include "lobby.hpp"
+#include "lobby_codes.hpp"
+#include "match_recorder.hpp"
+#include "player.hpp"
+
+using json = nlohmann::json;
+
+/**
+ * @class SessionManager
+ * @brief Tracks connections, lobbies and games and handles client messages
+ *
+ * Holds everything the server keeps per player, without the networking
+ * layer: replies go out through a send callback. This lets the same code run
+ * under websocketpp and in-process, e.g. in the session soak test.
+ */
+class SessionManager {
+public:
+    typedef std::function<void(connection_hdl, const json&)> SendFunction;
+
+    /**
+     * @brief Create an empty session manager
+     * @param send Delivers a message to a connection
+     * @param matchRecorder Destination for finished matches, may be null
+     */
+    explicit SessionManager(SendFunction send, MatchRecorder* matchRecorder = nullptr);
+
+    /**
+     * @brief Allocate a fresh lobby code for the Django backend
+     * @return New lobby code
+     */
+    std::string allocateLobbyCode();
+
+    /**
+     * @brief Dispatch a parsed client message by its type
+     * @param hdl Connection the message arrived on
+     * @param data Message body
+     */
+    void handleMessage(connection_hdl hdl, const json& data);
+
+    /**
+     * @brief Leave every lobby a closed connection had joined
+     * @param hdl Connection that closed
+     */
+    void closeConnection(connection_hdl hdl);
+
+    /**
+     * @brief Get player, lobby, game and lobby code counts
+     * @return JSON object for the stats endpoint
+     */
+    json getStats() const;
+
+    /**
+     * @brief Get number of connections that have joined a lobby
+     * @return Connection count
+     */
+    size_t playerCount() const { return m_connections.size(); }
+
+    /**
+     * @brief Get number of lobbies waiting for players or ready-ups
+     * @return Lobby count
+     */
+    size_t lobbyCount() const { return m_lobbies.size(); }
+
+    /**
+     * @brief Get number of running games
+     * @return Game count
+     */
+    size_t gameCount() const { return m_games.size(); }
+
+    /**
+     * @brief Get number of allocated or claimed lobby codes
+     * @return Live code count
+     */
+    size_t liveLobbyCodeCount() const { return m_lobbyCodes.liveCount(); }
+
+private:
+    /**
+     * @struct ConnectionState
+     * @brief Channels joined over one connection, one per lobby
+     */
+    struct ConnectionState {
+        std::map<std::string, std::string> channels;   ///< User ID playing in each lobby
+    };
+
+    SendFunction m_send;
+    MatchRecorder* m_matchRecorder;
+    std::map<connection_hdl, ConnectionState, std::owner_less<connection_hdl>> m_connections;
+    std::map<std::string, std::unique_ptr<Lobby>> m_lobbies;
+    std::map<std::string, std::unique_ptr<Game>> m_games;
+    LobbyCodeAllocator m_lobbyCodes;
+
+    /**
+     * @brief Handle player joining a lobby
+     *
+     * Each lobby joined becomes a channel on the connection, so one socket
+     * can take part in many games at once, but only as one user per lobby.
+     */
+    void handleJoinMessage(connection_hdl hdl, const json& data);
+
+    /**
+     * @brief Tell a client its join was refused
+     */
+    void rejectJoin(connection_hdl hdl, const std::string& lobbyCode, const std::string& reason);
+
+    /**
+     * @brief Handle player ready status with ship placement
+     */
+    void handleReadyMessage(connection_hdl hdl, const json& data);
+
+    /**
+     * @brief Handle attack messages during gameplay
+     */
+    void handleAttackMessage(connection_hdl hdl, const json& data);
+
+    /**
+     * @brief Handle a player leaving one lobby without closing the connection
+     */
+    void handleLeaveMessage(connection_hdl hdl, const json& data);
+
+    /**
+     * @brief Initialize a new game from a ready lobby
+     */
+    void startGame(Lobby& lobby);
+
+    /**
+     * @brief Hand a finished game to the match recorder
+     */
+    void recordMatch(const Game& game, const std::string& winnerId);
+
+    /**
+     * @brief Notify players of lobby changes (placeholder for future use)
+     */
+    void notifyLobbyUpdate(const Lobby& lobby);
+
+    /**
+     * @brief Work out which channel a message belongs to
+     *
+     * Messages name their lobby. Clients that omit it are routed to the
+     * connection's only channel.
+     *
+     * @return False if the connection has not joined a matching lobby
+     */
+    bool resolveChannel(connection_hdl hdl, const json& data, std::string& lobbyCode, std::string& userId);
+
+    /**
+     * @brief Take a player out of a lobby, abandoning its game if one is running
+     */
+    void leaveChannel(connection_hdl hdl, const std::string& lobbyCode, const std::string& userId);
+
+    /**
+     * @brief Forget a connection's membership of a lobby
+     */
+    void closeChannel(connection_hdl hdl, const std::string& lobbyCode);
+
+    /**
+     * @brief Send JSON message tagged with the lobby it belongs to
+     */
+    void sendToChannel(connection_hdl hdl, const std::string& lobbyCode, json data);
+};
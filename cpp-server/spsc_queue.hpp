@@ -0,0 +1,71 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Bounded lock-free queue for handing work between two threads
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscQueue
+ * @brief Fixed-capacity ring buffer with one producer and one consumer thread
+ *
+ * Neither push nor pop ever blocks or allocates; a full queue rejects the
+ * push and leaves the decision to the caller.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    /**
+     * @brief Create a queue
+     * @param capacity Maximum number of queued items
+     */
+    explicit SpscQueue(size_t capacity)
+        : m_slots(capacity + 1), m_head(0), m_tail(0) {}
+
+    /**
+     * @brief Enqueue an item (producer thread only)
+     * @param item Item to move into the queue
+     * @return False if the queue is full
+     */
+    bool tryPush(T&& item) {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t next = increment(tail);
+        if (next == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        m_slots[tail] = std::move(item);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Dequeue an item (consumer thread only)
+     * @param item Receives the dequeued item
+     * @return False if the queue is empty
+     */
+    bool tryPop(T& item) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = std::move(m_slots[head]);
+        m_head.store(increment(head), std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> m_slots;        ///< Ring storage with one spare slot
+    std::atomic<size_t> m_head;    ///< Next slot to pop, owned by consumer
+    std::atomic<size_t> m_tail;    ///< Next slot to push, owned by producer
+
+    size_t increment(size_t index) const {
+        return (index + 1) % m_slots.size();
+    }
+};
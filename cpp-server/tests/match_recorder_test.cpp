@@ -0,0 +1,310 @@
+/**
+ * @file match_recorder_test.cpp
+ * @brief Tests for MatchRecorder retry, spill and replay behaviour
+ *
+ * Results are written through a FileMatchSink wrapped in a sink that can be
+ * told to fail or to reject batches, so each test can take the backing store
+ * down and bring it back while checking what ends up in the output, spill
+ * and quarantine files.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "match_recorder.hpp"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #condition << std::endl; \
+            failures++; \
+        } \
+    } while (0)
+
+const char* kOutputPath = "match_recorder_test.out";
+const char* kSpillPath = "match_recorder_test.spill";
+const char* kQuarantinePath = "match_recorder_test.spill.rejected";
+
+/**
+ * @struct SinkControl
+ * @brief Switches shared between a test and the sink the recorder owns
+ */
+struct SinkControl {
+    std::atomic<bool> down{false};       ///< Fail every write while set
+    std::atomic<int> failuresLeft{0};    ///< Fail this many more writes, then recover
+    std::atomic<int> rejectionsLeft{0};  ///< Reject this many more batches outright
+    std::atomic<int> writes{0};          ///< Write attempts seen
+};
+
+/**
+ * @class FailingSink
+ * @brief FileMatchSink that fails or rejects on demand
+ */
+class FailingSink : public MatchSink {
+public:
+    FailingSink(const std::string& path, std::shared_ptr<SinkControl> control)
+        : m_file(path), m_control(control) {}
+
+    WriteStatus write(const std::vector<json>& batch) override {
+        m_control->writes++;
+        if (m_control->down) {
+            return WriteStatus::Retry;
+        }
+        if (m_control->failuresLeft > 0) {
+            m_control->failuresLeft--;
+            return WriteStatus::Retry;
+        }
+        if (m_control->rejectionsLeft > 0) {
+            m_control->rejectionsLeft--;
+            return WriteStatus::Rejected;
+        }
+        return m_file.write(batch);
+    }
+
+private:
+    FileMatchSink m_file;
+    std::shared_ptr<SinkControl> m_control;
+};
+
+MatchResult makeResult(const std::string& lobbyCode) {
+    MatchResult result;
+    result.lobbyCode = lobbyCode;
+    result.player1Id = "1";
+    result.player1Name = "alice";
+    result.player2Id = "2";
+    result.player2Name = "bob";
+    result.winnerId = "1";
+    result.outcome = "completed";
+    result.moves = 40;
+    result.startedAt = 1700000000000;
+    result.durationMs = 120000;
+    return result;
+}
+
+std::unique_ptr<MatchRecorder> makeRecorder(std::shared_ptr<SinkControl> control,
+                                            size_t maxSpillBytes = 16 * 1024 * 1024) {
+    std::unique_ptr<MatchSink> sink(new FailingSink(kOutputPath, control));
+    return std::unique_ptr<MatchRecorder>(new MatchRecorder(std::move(sink), kSpillPath,
+        maxSpillBytes, std::chrono::milliseconds(50)));
+}
+
+/**
+ * @brief Read the lobby code of every document in a JSON-lines file
+ */
+std::vector<std::string> readLobbies(const char* path) {
+    std::vector<std::string> lobbies;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        lobbies.push_back(json::parse(line).at("lobby").get<std::string>());
+    }
+    return lobbies;
+}
+
+bool fileExists(const char* path) {
+    return static_cast<bool>(std::ifstream(path));
+}
+
+size_t fileSize(const char* path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return in ? static_cast<size_t>(in.tellg()) : 0;
+}
+
+/**
+ * @brief Poll until a condition holds or a few seconds pass
+ */
+bool waitFor(const std::function<bool()>& condition) {
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+uint64_t stat(const MatchRecorder& recorder, const char* name) {
+    return recorder.getStats().at(name).get<uint64_t>();
+}
+
+void reset() {
+    std::remove(kOutputPath);
+    std::remove(kSpillPath);
+    std::remove(kQuarantinePath);
+}
+
+/**
+ * @brief A batch that fails a couple of times is retried, not spilled
+ */
+void testRetry() {
+    reset();
+    std::shared_ptr<SinkControl> control = std::make_shared<SinkControl>();
+    control->failuresLeft = 2;
+
+    std::unique_ptr<MatchRecorder> recorder = makeRecorder(control);
+    CHECK(recorder->record(makeResult("RETRY1")));
+    CHECK(waitFor([&] { return stat(*recorder, "written") == 1; }));
+
+    CHECK(control->writes == 3);
+    CHECK(stat(*recorder, "spilled") == 0);
+    CHECK(stat(*recorder, "dropped") == 0);
+    CHECK(!fileExists(kSpillPath));
+    CHECK(readLobbies(kOutputPath) == std::vector<std::string>{"RETRY1"});
+}
+
+/**
+ * @brief Batches that would push the spill file past its cap are dropped
+ */
+void testSpillCap() {
+    reset();
+    std::shared_ptr<SinkControl> control = std::make_shared<SinkControl>();
+    control->down = true;
+
+    size_t docBytes = makeResult("CAP000").toJson().dump().size() + 1;
+    std::unique_ptr<MatchRecorder> recorder = makeRecorder(control, docBytes * 2);
+
+    for (int i = 0; i < 4; ++i) {
+        CHECK(recorder->record(makeResult("CAP00" + std::to_string(i))));
+        CHECK(waitFor([&] {
+            return stat(*recorder, "spilled") + stat(*recorder, "dropped") == static_cast<uint64_t>(i + 1);
+        }));
+    }
+
+    CHECK(stat(*recorder, "spilled") == 2);
+    CHECK(stat(*recorder, "dropped") == 2);
+    CHECK(stat(*recorder, "written") == 0);
+    CHECK(fileSize(kSpillPath) <= docBytes * 2);
+    CHECK((readLobbies(kSpillPath) == std::vector<std::string>{"CAP000", "CAP001"}));
+}
+
+/**
+ * @brief Spilled results reach the sink ahead of results recorded later
+ */
+void testReplayOrdering() {
+    reset();
+    std::shared_ptr<SinkControl> control = std::make_shared<SinkControl>();
+    control->down = true;
+
+    std::unique_ptr<MatchRecorder> recorder = makeRecorder(control);
+    CHECK(recorder->record(makeResult("OLD001")));
+    CHECK(waitFor([&] { return stat(*recorder, "spilled") == 1; }));
+    CHECK(recorder->record(makeResult("OLD002")));
+    CHECK(waitFor([&] { return stat(*recorder, "spilled") == 2; }));
+
+    control->down = false;
+    CHECK(recorder->record(makeResult("NEW001")));
+    CHECK(waitFor([&] { return stat(*recorder, "written") == 3; }));
+
+    CHECK(stat(*recorder, "spilled") == 0);
+    CHECK(!fileExists(kSpillPath));
+    CHECK((readLobbies(kOutputPath) == std::vector<std::string>{"OLD001", "OLD002", "NEW001"}));
+}
+
+/**
+ * @brief A spill file left by a previous run is counted and replayed first
+ */
+void testRestartPickup() {
+    reset();
+    std::shared_ptr<SinkControl> control = std::make_shared<SinkControl>();
+    control->down = true;
+
+    {
+        std::unique_ptr<MatchRecorder> recorder = makeRecorder(control);
+        CHECK(recorder->record(makeResult("RUN101")));
+        CHECK(recorder->record(makeResult("RUN102")));
+    }
+    CHECK((readLobbies(kSpillPath) == std::vector<std::string>{"RUN101", "RUN102"}));
+    CHECK(!fileExists(kOutputPath));
+
+    control->down = false;
+    std::unique_ptr<MatchRecorder> recorder = makeRecorder(control);
+    CHECK(stat(*recorder, "spilled") == 2 || stat(*recorder, "written") == 2);
+    CHECK(recorder->record(makeResult("RUN201")));
+    recorder.reset();
+
+    CHECK(!fileExists(kSpillPath));
+    CHECK((readLobbies(kOutputPath) == std::vector<std::string>{"RUN101", "RUN102", "RUN201"}));
+}
+
+/**
+ * @brief A rejected batch is quarantined and later results still get through
+ */
+void testRejectedBatch() {
+    reset();
+    std::shared_ptr<SinkControl> control = std::make_shared<SinkControl>();
+    control->rejectionsLeft = 1;
+
+    std::unique_ptr<MatchRecorder> recorder = makeRecorder(control);
+    CHECK(recorder->record(makeResult("BAD001")));
+    CHECK(waitFor([&] { return stat(*recorder, "rejected") == 1; }));
+    CHECK(control->writes == 1);
+
+    CHECK(recorder->record(makeResult("GOOD01")));
+    CHECK(recorder->record(makeResult("GOOD02")));
+    CHECK(waitFor([&] { return stat(*recorder, "written") == 2; }));
+
+    CHECK(stat(*recorder, "spilled") == 0);
+    CHECK(stat(*recorder, "dropped") == 0);
+    CHECK(!fileExists(kSpillPath));
+    CHECK((readLobbies(kQuarantinePath) == std::vector<std::string>{"BAD001"}));
+    CHECK((readLobbies(kOutputPath) == std::vector<std::string>{"GOOD01", "GOOD02"}));
+}
+
+/**
+ * @brief A spilled batch rejected on replay is quarantined instead of blocking the spill
+ */
+void testRejectedOnReplay() {
+    reset();
+    std::shared_ptr<SinkControl> control = std::make_shared<SinkControl>();
+    control->down = true;
+
+    std::unique_ptr<MatchRecorder> recorder = makeRecorder(control);
+    CHECK(recorder->record(makeResult("BAD002")));
+    CHECK(waitFor([&] { return stat(*recorder, "spilled") == 1; }));
+
+    control->rejectionsLeft = 1;
+    control->down = false;
+    CHECK(recorder->record(makeResult("GOOD03")));
+    CHECK(waitFor([&] { return stat(*recorder, "written") == 1; }));
+
+    CHECK(stat(*recorder, "rejected") == 1);
+    CHECK(stat(*recorder, "spilled") == 0);
+    CHECK(!fileExists(kSpillPath));
+    CHECK((readLobbies(kQuarantinePath) == std::vector<std::string>{"BAD002"}));
+    CHECK((readLobbies(kOutputPath) == std::vector<std::string>{"GOOD03"}));
+}
+
+}  // namespace
+
+/**
+ * @brief Run every test and report failures through the exit code
+ */
+int main() {
+    testRetry();
+    testSpillCap();
+    testReplayOrdering();
+    testRestartPickup();
+    testRejectedBatch();
+    testRejectedOnReplay();
+    reset();
+
+    if (failures) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All match recorder tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,418 @@
+/**
+ * @file session_soak.cpp
+ * @brief In-process soak of SessionManager with allocation counting
+ *
+ * Drives the same SessionManager the server uses through many match
+ * lifecycles without sockets: connections are plain shared objects and
+ * replies land in per-client inboxes. Matches finish or are abandoned at
+ * every phase (alone in the lobby, with both players, after one ready-up,
+ * mid-game by disconnect or by a leave message), and some attract rejected
+ * joins and a second lobby on the same connection.
+ *
+ * Global operator new and delete are replaced to count allocations. After
+ * each round every session map and live Lobby/Game count must be back to
+ * zero, and once warm neither the number of live heap blocks nor resident
+ * memory may grow past a tolerance.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "process_stats.hpp"
+#include "session_manager.hpp"
+#include "trace.hpp"
+
+// operator delete below frees what operator new got from malloc, which GCC
+// cannot see through once they are inlined into each other
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+std::atomic<uint64_t> g_allocations(0);   ///< Blocks handed out by operator new
+std::atomic<uint64_t> g_frees(0);         ///< Blocks returned to operator delete
+std::atomic<uint64_t> g_bytes(0);         ///< Bytes requested from operator new
+
+void* countedAlloc(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void countedFree(void* ptr) {
+    if (!ptr) return;
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+    std::free(ptr);
+}
+}
+
+void* operator new(std::size_t size) {
+    void* ptr = countedAlloc(size);
+    if (!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+
+namespace {
+
+/**
+ * @enum Phase
+ * @brief How a soak match ends
+ */
+enum Phase {
+    kComplete,     ///< Played to the last ship
+    kLobbyAlone,   ///< Host disconnects before anyone joins
+    kLobby,        ///< Both joined, host disconnects
+    kReady,        ///< Host readied up, then disconnects
+    kGame,         ///< Host disconnects mid-game
+    kLeave,        ///< Host sends leave mid-game, then disconnects
+    kRejected,     ///< Full-lobby and wrong-user joins, plus a second lobby on one socket
+    kPhaseCount
+};
+
+const char* kPhaseNames[kPhaseCount] = {
+    "complete", "lobby-alone", "lobby", "ready", "game", "leave", "rejected"
+};
+
+/**
+ * @struct Client
+ * @brief Stand-in for a WebSocket connection; its address is the handle
+ */
+struct Client {
+    std::string user;
+    std::vector<json> inbox;   ///< Messages the server sent to this connection
+};
+
+typedef std::shared_ptr<Client> ClientPtr;
+
+/**
+ * @class SoakDriver
+ * @brief Plays scripted matches against a SessionManager
+ */
+class SoakDriver {
+public:
+    SoakDriver()
+        : m_sessions([](connection_hdl hdl, const json& data) {
+              ClientPtr client = std::static_pointer_cast<Client>(hdl.lock());
+              if (client) client->inbox.push_back(data);
+          }),
+          m_errors(0) {}
+
+    SessionManager& sessions() { return m_sessions; }
+    uint64_t errors() const { return m_errors; }
+
+    /**
+     * @brief Play one match that ends at the given phase
+     */
+    void playMatch(uint64_t index, Phase phase) {
+        std::string lobby = m_sessions.allocateLobbyCode();
+        std::string prefix = "soak-" + std::to_string(index);
+        ClientPtr host = connect(prefix + "-a");
+        ClientPtr guest = connect(prefix + "-b");
+
+        join(host, lobby, host->user);
+        expect(host, "joinConfirmed");
+        if (phase == kLobbyAlone) {
+            close(host);
+            close(guest);
+            return;
+        }
+
+        join(guest, lobby, guest->user);
+        expect(guest, "joinConfirmed");
+        expect(host, "opponentJoined");
+
+        if (phase == kRejected) {
+            playRejected(prefix, lobby, host, guest);
+            return;
+        }
+        if (phase == kLobby) {
+            close(host);
+            close(guest);
+            return;
+        }
+
+        ready(host, lobby);
+        if (phase == kReady) {
+            close(host);
+            close(guest);
+            return;
+        }
+        ready(guest, lobby);
+
+        json start = expect(host, "gameStart");
+        expect(guest, "gameStart");
+        playGame(lobby, host, guest, start.value("firstPlayer", ""), phase);
+
+        close(host);
+        close(guest);
+    }
+
+private:
+    SessionManager m_sessions;
+    uint64_t m_errors;
+
+    ClientPtr connect(const std::string& user) {
+        ClientPtr client = std::make_shared<Client>();
+        client->user = user;
+        return client;
+    }
+
+    void close(ClientPtr& client) {
+        m_sessions.closeConnection(connection_hdl(client));
+        client.reset();
+    }
+
+    void send(const ClientPtr& client, const json& data) {
+        client->inbox.clear();
+        m_sessions.handleMessage(connection_hdl(client), data);
+    }
+
+    void join(const ClientPtr& client, const std::string& lobby, const std::string& user) {
+        send(client, {{"type", "join"}, {"lobby", lobby}, {"user", user}, {"username", user}});
+    }
+
+    void ready(const ClientPtr& client, const std::string& lobby) {
+        // Ship cells as y * 10 + x, matching the ids the web client sends
+        static const json board = {
+            {"ship5", {0, 1, 2, 3, 4}},
+            {"ship4", {20, 21, 22, 23}},
+            {"ship3a", {40, 41, 42}},
+            {"ship3b", {60, 61, 62}},
+            {"ship2", {80, 81}}
+        };
+        send(client, {{"type", "ready"}, {"lobby", lobby}, {"board", board}});
+    }
+
+    /**
+     * @brief Find the latest message of a type in an inbox, counting an error if absent
+     */
+    json expect(const ClientPtr& client, const std::string& type) {
+        for (auto it = client->inbox.rbegin(); it != client->inbox.rend(); ++it) {
+            if (it->value("type", "") == type) return *it;
+        }
+        if (m_errors++ < 10) {
+            std::cerr << client->user << " did not receive " << type << std::endl;
+        }
+        return json::object();
+    }
+
+    /**
+     * @brief Alternate attacks until the game ends or the host walks away
+     *
+     * The host aims at the guest's ships; the guest only fires at rows
+     * without ships, so the host always wins a completed game.
+     */
+    void playGame(const std::string& lobby, ClientPtr& host, ClientPtr& guest,
+                  const std::string& firstPlayer, Phase phase) {
+        static const int shipCells[] = {0, 1, 2, 3, 4, 20, 21, 22, 23, 40, 41, 42, 60, 61, 62, 80, 81};
+        size_t hostShot = 0;
+        int guestShot = 0;
+        bool hostTurn = firstPlayer == host->user;
+
+        for (int moves = 0; moves < 200; ++moves) {
+            if (moves == 5 && (phase == kGame || phase == kLeave)) {
+                if (phase == kLeave) {
+                    send(host, {{"type", "leave"}, {"lobby", lobby}});
+                    expect(guest, "opponentDisconnected");
+                } else {
+                    guest->inbox.clear();
+                    close(host);
+                    expect(guest, "opponentDisconnected");
+                }
+                return;
+            }
+
+            ClientPtr& attacker = hostTurn ? host : guest;
+            int cell;
+            if (hostTurn) {
+                cell = shipCells[hostShot++];
+            } else {
+                cell = (guestShot / 10 * 2 + 1) * 10 + guestShot % 10;
+                guestShot++;
+            }
+            send(attacker, {{"type", "attack"}, {"lobby", lobby}, {"x", cell % 10}, {"y", cell / 10}});
+
+            json result = expect(attacker, "attackResult");
+            if (result.value("gameOver", false)) {
+                expect(attacker, "gameOver");
+                if (result.value("winner", "") != host->user) m_errors++;
+                return;
+            }
+            hostTurn = result.value("nextPlayer", "") == host->user;
+        }
+
+        m_errors++;
+        std::cerr << "Game in lobby " << lobby << " did not finish" << std::endl;
+    }
+
+    /**
+     * @brief Joins that must be refused, and a second lobby on the host's socket
+     */
+    void playRejected(const std::string& prefix, const std::string& lobby,
+                      ClientPtr& host, ClientPtr& guest) {
+        ClientPtr intruder = connect(prefix + "-c");
+        join(intruder, lobby, intruder->user);
+        expect(intruder, "joinRejected");
+
+        join(host, lobby, guest->user);
+        expect(host, "joinRejected");
+
+        std::string second = m_sessions.allocateLobbyCode();
+        join(host, second, prefix + "-a2");
+        expect(host, "joinConfirmed");
+        join(intruder, second, intruder->user);
+        expect(intruder, "joinConfirmed");
+
+        // Closing the host's socket must empty both of its lobbies
+        close(host);
+        close(intruder);
+        close(guest);
+    }
+};
+
+/**
+ * @brief Check that nothing outlives the connections that created it
+ * @return Names and values of counters that are not zero
+ */
+std::string leaks(const SessionManager& sessions) {
+    std::string report;
+    auto check = [&](const char* name, size_t value) {
+        if (value != 0) report += std::string(report.empty() ? "" : ", ") + name + "=" + std::to_string(value);
+    };
+    check("players", sessions.playerCount());
+    check("lobbies", sessions.lobbyCount());
+    check("games", sessions.gameCount());
+    check("liveLobbyCodes", sessions.liveLobbyCodeCount());
+    check("live Lobby objects", Lobby::liveCount());
+    check("live Game objects", Game::liveCount());
+    return report;
+}
+
+uint64_t liveBlocks() {
+    return g_allocations.load() - g_frees.load();
+}
+
+}  // namespace
+
+/**
+ * @brief Run the soak and report through the exit code
+ */
+int main(int argc, char* argv[]) {
+    uint64_t matches = 200000;
+    uint64_t roundSize = 1000;
+    int warmupRounds = 5;
+    uint64_t blockTolerance = 64;
+    uint64_t rssToleranceMb = 16;
+
+    auto usage = [] {
+        std::cerr << "Usage: session_soak [--matches N] [--round-size N] [--warmup-rounds N] "
+                  << "[--block-tolerance N] [--rss-tolerance-mb N]" << std::endl;
+        return 1;
+    };
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string arg = argv[i];
+        if (i + 1 == argc) return usage();   // Every flag takes a value
+        uint64_t value = std::strtoull(argv[i + 1], nullptr, 10);
+        if (arg == "--matches") matches = value;
+        else if (arg == "--round-size") roundSize = std::max<uint64_t>(value, 1);
+        else if (arg == "--warmup-rounds") warmupRounds = static_cast<int>(value);
+        else if (arg == "--block-tolerance") blockTolerance = value;
+        else if (arg == "--rss-tolerance-mb") rssToleranceMb = value;
+        else return usage();
+    }
+
+    // The session code logs every message; keep the report readable
+    std::ostream report(std::cout.rdbuf());
+    std::cout.rdbuf(nullptr);
+    Tracer::setEnabled(false);
+
+    SoakDriver driver;
+    uint64_t phaseMatches[kPhaseCount] = {};
+    uint64_t phaseAllocations[kPhaseCount] = {};
+    uint64_t phaseBytes[kPhaseCount] = {};
+    // Without warm-up rounds the baseline is the state before any match
+    uint64_t warmBlocks = liveBlocks();
+    size_t warmRss = getResidentBytes();
+    int round = 0;
+
+    for (uint64_t done = 0; done < matches; ) {
+        uint64_t count = std::min(roundSize, matches - done);
+        for (uint64_t i = 0; i < count; ++i, ++done) {
+            Phase phase = static_cast<Phase>(done % kPhaseCount);
+            uint64_t allocations = g_allocations.load();
+            uint64_t bytes = g_bytes.load();
+            driver.playMatch(done, phase);
+            phaseMatches[phase]++;
+            phaseAllocations[phase] += g_allocations.load() - allocations;
+            phaseBytes[phase] += g_bytes.load() - bytes;
+        }
+        round++;
+
+        std::string leaked = leaks(driver.sessions());
+        if (!leaked.empty()) {
+            report << "Leak after " << done << " matches: " << leaked << std::endl;
+            return 1;
+        }
+        if (driver.errors()) {
+            report << driver.errors() << " protocol errors after " << done << " matches" << std::endl;
+            return 1;
+        }
+
+        uint64_t blocks = liveBlocks();
+        size_t rss = getResidentBytes();
+        if (round == warmupRounds) {
+            warmBlocks = blocks;
+            warmRss = rss;
+        } else if (round > warmupRounds) {
+            if (blocks > warmBlocks + blockTolerance) {
+                report << "Live heap blocks drifted from " << warmBlocks << " to " << blocks
+                       << " after " << done << " matches" << std::endl;
+                return 1;
+            }
+            if (rss > warmRss + rssToleranceMb * 1024 * 1024) {
+                report << "RSS drifted from " << warmRss / (1024 * 1024) << " MB to "
+                       << rss / (1024 * 1024) << " MB after " << done << " matches" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    report << matches << " matches, " << liveBlocks() << " live heap blocks ("
+           << warmBlocks << " after warm-up), rss " << getResidentBytes() / (1024 * 1024) << " MB ("
+           << warmRss / (1024 * 1024) << " MB after warm-up)\n"
+           << "Lobby objects created: " << Lobby::createdCount()
+           << ", Game objects created: " << Game::createdCount() << "\n"
+           << "Allocations per match by phase:\n";
+    for (int phase = 0; phase < kPhaseCount; ++phase) {
+        uint64_t played = std::max<uint64_t>(phaseMatches[phase], 1);
+        report << "  " << kPhaseNames[phase] << ": " << phaseAllocations[phase] / played
+               << " allocations, " << phaseBytes[phase] / played << " bytes" << std::endl;
+    }
+    report << "Soak passed" << std::endl;
+    return 0;
+}
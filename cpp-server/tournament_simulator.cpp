@@ -0,0 +1,599 @@
+/**
+ * @file tournament_simulator.cpp
+ * @brief Offline tournament simulator built on the Game engine
+ *
+ * Plays large numbers of matches between two configurable players without
+ * the networking layer, spreading them across all cores with a
+ * work-stealing scheduler. Reports win rates, match length and engine
+ * throughput, for balancing fleets and as a regression check on
+ * Game::processAttack.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game.hpp"
+#include "lobby.hpp"
+
+namespace {
+
+const int kBoardSize = 10;
+const int kCells = kBoardSize * kBoardSize;
+const int kPlacementRestarts = 100;   ///< Whole-fleet placement attempts before giving up
+
+/**
+ * @brief Convert board coordinates to a cell index
+ */
+int cellIndex(int x, int y) {
+    return y * kBoardSize + x;
+}
+
+/**
+ * @class Targeter
+ * @brief Chooses shots for one player during one match
+ */
+class Targeter {
+public:
+    virtual ~Targeter() = default;
+
+    /**
+     * @brief Pick the next cell to attack
+     * @return Cell index that has not been attacked yet
+     */
+    virtual int nextShot() = 0;
+
+    /**
+     * @brief Learn the outcome of the last shot
+     * @param cell Cell that was attacked
+     * @param hit Whether a ship was hit
+     * @param sunk Whether the hit sank the ship
+     */
+    virtual void onResult(int cell, bool hit, bool sunk) = 0;
+};
+
+/**
+ * @class RandomTargeter
+ * @brief Fires at every cell in a random order
+ */
+class RandomTargeter : public Targeter {
+public:
+    explicit RandomTargeter(std::mt19937& rng) : m_order(kCells), m_next(0) {
+        for (int i = 0; i < kCells; ++i) m_order[i] = i;
+        std::shuffle(m_order.begin(), m_order.end(), rng);
+    }
+
+    int nextShot() override {
+        return m_order[m_next++];
+    }
+
+    void onResult(int, bool, bool) override {}
+
+private:
+    std::vector<int> m_order;
+    size_t m_next;
+};
+
+/**
+ * @class HuntTargeter
+ * @brief Searches at random, then works outwards from each hit until the ship sinks
+ *
+ * With parity enabled the search only covers one colour of the
+ * checkerboard first, since every ship of length 2 or more covers both.
+ */
+class HuntTargeter : public Targeter {
+public:
+    HuntTargeter(std::mt19937& rng, bool parity) : m_tried(kCells, false), m_next(0) {
+        for (int i = 0; i < kCells; ++i) m_order.push_back(i);
+        std::shuffle(m_order.begin(), m_order.end(), rng);
+        if (parity) {
+            std::stable_partition(m_order.begin(), m_order.end(),
+                [](int cell) { return (cell % kBoardSize + cell / kBoardSize) % 2 == 0; });
+        }
+    }
+
+    int nextShot() override {
+        while (!m_targets.empty()) {
+            int cell = m_targets.back();
+            m_targets.pop_back();
+            if (!m_tried[cell]) return take(cell);
+        }
+        while (m_tried[m_order[m_next]]) {
+            m_next++;
+        }
+        return take(m_order[m_next]);
+    }
+
+    void onResult(int cell, bool hit, bool sunk) override {
+        if (sunk) {
+            m_targets.clear();
+            return;
+        }
+        if (!hit) return;
+
+        int x = cell % kBoardSize;
+        int y = cell / kBoardSize;
+        if (x > 0) m_targets.push_back(cellIndex(x - 1, y));
+        if (x < kBoardSize - 1) m_targets.push_back(cellIndex(x + 1, y));
+        if (y > 0) m_targets.push_back(cellIndex(x, y - 1));
+        if (y < kBoardSize - 1) m_targets.push_back(cellIndex(x, y + 1));
+    }
+
+private:
+    std::vector<bool> m_tried;
+    std::vector<int> m_order;     ///< Search order when no hits are pending
+    std::vector<int> m_targets;   ///< Neighbours of recent hits
+    size_t m_next;
+
+    int take(int cell) {
+        m_tried[cell] = true;
+        return cell;
+    }
+};
+
+typedef std::function<std::unique_ptr<Targeter>(std::mt19937&)> TargeterFactory;
+typedef std::function<json(const std::vector<int>&, std::mt19937&)> Placement;
+
+/**
+ * @brief Place a fleet at random, filtering candidate positions
+ * @param fleet Ship lengths
+ * @param rng Random generator
+ * @param accept Extra rule a position must satisfy; dropped after repeated failures
+ * @return Board as ship ID to cell indices, matching what clients send, or
+ *         null if the fleet could not be placed
+ */
+json placeFleet(const std::vector<int>& fleet, std::mt19937& rng,
+                const std::function<bool(const std::vector<bool>&, const std::vector<int>&)>& accept) {
+    std::uniform_int_distribution<int> coord(0, kBoardSize - 1);
+    std::uniform_int_distribution<int> orientation(0, 1);
+
+    for (int restart = 0; restart < kPlacementRestarts; ++restart) {
+        std::vector<bool> occupied(kCells, false);
+        json board = json::object();
+        bool placedAll = true;
+
+        for (size_t ship = 0; ship < fleet.size() && placedAll; ++ship) {
+            int length = fleet[ship];
+            bool placed = false;
+
+            for (int attempt = 0; attempt < 1000 && !placed; ++attempt) {
+                bool vertical = orientation(rng) == 1;
+                int x = coord(rng);
+                int y = coord(rng);
+                if ((vertical ? y : x) + length > kBoardSize) continue;
+
+                std::vector<int> cells;
+                for (int i = 0; i < length; ++i) {
+                    cells.push_back(vertical ? cellIndex(x, y + i) : cellIndex(x + i, y));
+                }
+                if (std::any_of(cells.begin(), cells.end(), [&](int c) { return occupied[c]; })) continue;
+                if (attempt < 200 && !accept(occupied, cells)) continue;
+
+                for (int c : cells) occupied[c] = true;
+                board["ship" + std::to_string(ship)] = cells;
+                placed = true;
+            }
+            placedAll = placed;
+        }
+
+        if (placedAll) return board;
+    }
+
+    return json();
+}
+
+/**
+ * @brief Check whether any cell lies on the outer edge of the board
+ */
+bool touchesEdge(const std::vector<int>& cells) {
+    return std::any_of(cells.begin(), cells.end(), [](int c) {
+        int x = c % kBoardSize;
+        int y = c / kBoardSize;
+        return x == 0 || y == 0 || x == kBoardSize - 1 || y == kBoardSize - 1;
+    });
+}
+
+/**
+ * @brief Check whether any cell is next to an occupied cell, diagonals included
+ */
+bool touchesShip(const std::vector<bool>& occupied, const std::vector<int>& cells) {
+    for (int c : cells) {
+        int x = c % kBoardSize;
+        int y = c / kBoardSize;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = x + dx;
+                int ny = y + dy;
+                if (nx < 0 || ny < 0 || nx >= kBoardSize || ny >= kBoardSize) continue;
+                if (occupied[cellIndex(nx, ny)]) return true;
+            }
+        }
+    }
+    return false;
+}
+
+const std::map<std::string, Placement>& placements() {
+    static const std::map<std::string, Placement> registry = {
+        {"random", [](const std::vector<int>& fleet, std::mt19937& rng) {
+            return placeFleet(fleet, rng, [](const std::vector<bool>&, const std::vector<int>&) { return true; });
+        }},
+        {"edges", [](const std::vector<int>& fleet, std::mt19937& rng) {
+            return placeFleet(fleet, rng, [](const std::vector<bool>&, const std::vector<int>& cells) {
+                return touchesEdge(cells);
+            });
+        }},
+        {"spread", [](const std::vector<int>& fleet, std::mt19937& rng) {
+            return placeFleet(fleet, rng, [](const std::vector<bool>& occupied, const std::vector<int>& cells) {
+                return !touchesShip(occupied, cells);
+            });
+        }}
+    };
+    return registry;
+}
+
+const std::map<std::string, TargeterFactory>& targeters() {
+    static const std::map<std::string, TargeterFactory> registry = {
+        {"random", [](std::mt19937& rng) {
+            return std::unique_ptr<Targeter>(new RandomTargeter(rng));
+        }},
+        {"hunt", [](std::mt19937& rng) {
+            return std::unique_ptr<Targeter>(new HuntTargeter(rng, false));
+        }},
+        {"parity", [](std::mt19937& rng) {
+            return std::unique_ptr<Targeter>(new HuntTargeter(rng, true));
+        }}
+    };
+    return registry;
+}
+
+/**
+ * @struct Contestant
+ * @brief One side of the tournament: a placement and a targeting strategy
+ */
+struct Contestant {
+    std::string placementName;
+    std::string targeterName;
+    Placement placement;
+    TargeterFactory targeter;
+};
+
+/**
+ * @struct WorkerStats
+ * @brief Results gathered by one worker thread
+ */
+struct alignas(64) WorkerStats {
+    uint64_t games = 0;
+    uint64_t wins[2] = {0, 0};
+    uint64_t moves = 0;
+    uint64_t unfinished = 0;
+    uint64_t unplaced = 0;   ///< Matches skipped because a fleet could not be placed
+    uint64_t engineNs = 0;   ///< Time spent inside Game::processAttack
+};
+
+/**
+ * @brief Play one match through the same Lobby and Game flow the server uses
+ * @param contestants The two sides
+ * @param fleet Ship lengths
+ * @param seed Per-match seed, so results do not depend on scheduling
+ * @param stats Worker results to update
+ */
+void playMatch(const Contestant* contestants, const std::vector<int>& fleet,
+               uint64_t seed, WorkerStats& stats) {
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+
+    Lobby lobby("SIM000");
+    Player players[2] = {
+        Player("A", "A", connection_hdl()),
+        Player("B", "B", connection_hdl())
+    };
+    for (int side = 0; side < 2; ++side) {
+        json board = contestants[side].placement(fleet, rng);
+        if (board.is_null()) {
+            stats.unplaced++;
+            return;
+        }
+        lobby.addPlayer(players[side]);
+        lobby.setPlayerReady(players[side].id, board);
+    }
+
+    Game game(lobby.getLobbyCode(), players[0], players[1],
+              lobby.getPlayerBoard(players[0].id), lobby.getPlayerBoard(players[1].id));
+    std::unique_ptr<Targeter> targeters[2] = {
+        contestants[0].targeter(rng),
+        contestants[1].targeter(rng)
+    };
+
+    int turn = game.decideFirstPlayer(rng);
+    int moves = 0;
+    bool finished = false;
+
+    while (moves < 2 * kCells) {
+        int cell = targeters[turn]->nextShot();
+
+        // Time the engine alone; targeters can cost far more than the attack itself
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        AttackResult result = game.processAttack(players[turn].id, cell % kBoardSize, cell / kBoardSize);
+        stats.engineNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        targeters[turn]->onResult(cell, result.hit, result.shipSunk);
+        moves++;
+
+        if (result.gameOver) {
+            stats.wins[result.winnerId == players[0].id ? 0 : 1]++;
+            finished = true;
+            break;
+        }
+        turn = (result.nextPlayerId == players[0].id) ? 0 : 1;
+    }
+
+    stats.games++;
+    stats.moves += moves;
+    if (!finished) stats.unfinished++;
+}
+
+/**
+ * @class WorkStealingScheduler
+ * @brief Runs a range of work items across threads with per-thread deques
+ *
+ * Each worker owns a deque of index ranges. It repeatedly takes the range at
+ * the back, splits off the upper half onto its own deque until the range is
+ * no larger than the grain, then runs it. Idle workers steal from the front
+ * of another worker's deque, where the largest ranges sit.
+ */
+class WorkStealingScheduler {
+public:
+    typedef std::function<void(size_t worker, uint64_t begin, uint64_t end)> Body;
+
+    /**
+     * @brief Create a scheduler
+     * @param workers Number of worker threads
+     * @param grain Largest range handed to the body at once
+     */
+    WorkStealingScheduler(size_t workers, uint64_t grain)
+        : m_queues(workers), m_grain(std::max<uint64_t>(grain, 1)), m_remaining(0) {}
+
+    /**
+     * @brief Run body over [0, total) and wait for completion
+     * @param total Number of work items
+     * @param body Callback for each range
+     */
+    void run(uint64_t total, const Body& body) {
+        m_remaining = total;
+        size_t workers = m_queues.size();
+        for (size_t w = 0; w < workers; ++w) {
+            uint64_t begin = total * w / workers;
+            uint64_t end = total * (w + 1) / workers;
+            if (begin < end) m_queues[w].ranges.push_back(Range{begin, end});
+        }
+
+        std::vector<std::thread> threads;
+        for (size_t w = 0; w < workers; ++w) {
+            threads.emplace_back(&WorkStealingScheduler::workerLoop, this, w, std::cref(body));
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    struct Range {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    std::vector<Queue> m_queues;
+    uint64_t m_grain;
+    std::atomic<uint64_t> m_remaining;   ///< Work items not yet completed
+
+    void workerLoop(size_t worker, const Body& body) {
+        std::mt19937 rng(static_cast<std::mt19937::result_type>(worker));
+        Range range;
+
+        while (m_remaining.load() > 0) {
+            if (!popLocal(worker, range) && !steal(worker, rng, range)) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            while (range.end - range.begin > m_grain) {
+                uint64_t mid = range.begin + (range.end - range.begin) / 2;
+                pushLocal(worker, Range{mid, range.end});
+                range.end = mid;
+            }
+
+            body(worker, range.begin, range.end);
+            m_remaining -= range.end - range.begin;
+        }
+    }
+
+    void pushLocal(size_t worker, const Range& range) {
+        std::lock_guard<std::mutex> lock(m_queues[worker].mutex);
+        m_queues[worker].ranges.push_back(range);
+    }
+
+    bool popLocal(size_t worker, Range& range) {
+        std::lock_guard<std::mutex> lock(m_queues[worker].mutex);
+        if (m_queues[worker].ranges.empty()) return false;
+        range = m_queues[worker].ranges.back();
+        m_queues[worker].ranges.pop_back();
+        return true;
+    }
+
+    bool steal(size_t worker, std::mt19937& rng, Range& range) {
+        size_t workers = m_queues.size();
+        size_t offset = std::uniform_int_distribution<size_t>(1, std::max<size_t>(workers, 2) - 1)(rng);
+        for (size_t i = 0; i < workers - 1; ++i) {
+            size_t victim = (worker + offset + i) % workers;
+            if (victim == worker) continue;
+            std::lock_guard<std::mutex> lock(m_queues[victim].mutex);
+            if (!m_queues[victim].ranges.empty()) {
+                range = m_queues[victim].ranges.front();
+                m_queues[victim].ranges.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Parse a "placement:targeting" pair into a contestant
+ * @return False if either strategy is unknown
+ */
+bool parseContestant(const std::string& spec, Contestant& contestant) {
+    size_t colon = spec.find(':');
+    contestant.placementName = spec.substr(0, colon);
+    contestant.targeterName = (colon == std::string::npos) ? "hunt" : spec.substr(colon + 1);
+
+    auto placement = placements().find(contestant.placementName);
+    auto targeter = targeters().find(contestant.targeterName);
+    if (placement == placements().end() || targeter == targeters().end()) return false;
+
+    contestant.placement = placement->second;
+    contestant.targeter = targeter->second;
+    return true;
+}
+
+/**
+ * @brief Parse a comma-separated list of ship lengths
+ * @return False if the list is empty, a length does not fit on the board or
+ *         the ships need more cells than the board has
+ */
+bool parseFleet(const std::string& spec, std::vector<int>& fleet) {
+    fleet.clear();
+    std::stringstream stream(spec);
+    std::string item;
+    int totalCells = 0;
+    while (std::getline(stream, item, ',')) {
+        int length = std::atoi(item.c_str());
+        if (length < 1 || length > kBoardSize) return false;
+        totalCells += length;
+        if (totalCells > kCells) return false;
+        fleet.push_back(length);
+    }
+    return !fleet.empty();
+}
+
+/**
+ * @brief Check that both contestants can place the fleet at all
+ *
+ * A fleet can fit by cell count and still be impossible or very unlikely to
+ * place at random (ten ships of length 10, say).
+ */
+bool fleetPlaceable(const Contestant* contestants, const std::vector<int>& fleet, uint64_t seed) {
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+    for (int side = 0; side < 2; ++side) {
+        if (contestants[side].placement(fleet, rng).is_null()) return false;
+    }
+    return true;
+}
+
+void printUsage() {
+    std::cerr << "Usage: battleship_sim [--games N] [--threads N] [--seed N]\n"
+              << "                      [--a PLACEMENT:TARGETING] [--b PLACEMENT:TARGETING]\n"
+              << "                      [--fleet 5,4,3,3,2]\n"
+              << "Placements: random, edges, spread\n"
+              << "Targeting:  random, hunt, parity" << std::endl;
+}
+
+}
+
+/**
+ * @brief Main entry point for the tournament simulator
+ */
+int main(int argc, char* argv[]) {
+    uint64_t games = 1000000;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t seed = 1;
+    std::string specs[2] = {"random:hunt", "random:hunt"};
+    std::string fleetSpec = "5,4,3,3,2";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage();
+            return 1;
+        }
+        std::string value = argv[++i];
+        if (arg == "--games") games = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--threads") threads = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--seed") seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--a") specs[0] = value;
+        else if (arg == "--b") specs[1] = value;
+        else if (arg == "--fleet") fleetSpec = value;
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    Contestant contestants[2];
+    std::vector<int> fleet;
+    if (!parseContestant(specs[0], contestants[0]) || !parseContestant(specs[1], contestants[1])
+        || !parseFleet(fleetSpec, fleet)) {
+        printUsage();
+        return 1;
+    }
+
+    if (!fleetPlaceable(contestants, fleet, seed)) {
+        std::cerr << "Fleet " << fleetSpec << " could not be placed on a "
+                  << kBoardSize << "x" << kBoardSize << " board" << std::endl;
+        return 1;
+    }
+
+    std::vector<WorkerStats> workerStats(threads);
+    WorkStealingScheduler scheduler(threads, 256);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    scheduler.run(games, [&](size_t worker, uint64_t begin, uint64_t end) {
+        for (uint64_t match = begin; match < end; ++match) {
+            playMatch(contestants, fleet, seed * 0x9E3779B97F4A7C15ULL + match, workerStats[worker]);
+        }
+    });
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    WorkerStats total;
+    for (const WorkerStats& stats : workerStats) {
+        total.games += stats.games;
+        total.wins[0] += stats.wins[0];
+        total.wins[1] += stats.wins[1];
+        total.moves += stats.moves;
+        total.unfinished += stats.unfinished;
+        total.unplaced += stats.unplaced;
+        total.engineNs += stats.engineNs;
+    }
+
+    double played = static_cast<double>(std::max<uint64_t>(total.games, 1));
+    std::cout << std::fixed << std::setprecision(2)
+              << "Games:            " << total.games << " on " << threads << " threads in "
+              << elapsed << " s\n"
+              << "A (" << specs[0] << ") wins: " << 100.0 * total.wins[0] / played << "%\n"
+              << "B (" << specs[1] << ") wins: " << 100.0 * total.wins[1] / played << "%\n"
+              << "Unfinished:       " << total.unfinished << "\n"
+              << "Unplaced fleets:  " << total.unplaced << "\n"
+              << "Avg match length: " << total.moves / played << " moves\n"
+              << "Throughput:       " << std::setprecision(0) << total.games / elapsed << " games/s\n"
+              << "processAttack:    " << (total.engineNs ? total.moves * 1e9 / total.engineNs : 0)
+              << " attacks/s per thread" << std::endl;
+
+    return total.unfinished == 0 && total.unplaced == 0 ? 0 : 2;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file trace.cpp
+ * @brief Implementation of span tracing and Chrome trace export
+ */
+
+#include "trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+/// A finished span as stored in a ring
+struct SpanRecord {
+    const char* name;
+    char lobby[16];
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+/// Fixed-size span ring owned by one thread
+struct ThreadBuffer {
+    explicit ThreadBuffer(size_t threadId) : threadId(threadId), spans(Tracer::kSpansPerThread), written(0) {}
+
+    size_t threadId;
+    std::mutex mutex;               ///< Only contended while a dump is running
+    std::vector<SpanRecord> spans;
+    uint64_t written;               ///< Total spans ever written to this ring
+};
+
+std::atomic<bool> g_enabled(true);
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+/// All rings ever created; kept after their thread exits so spans stay dumpable
+std::mutex g_registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> g_registry;
+
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+thread_local std::string t_lobby;
+
+ThreadBuffer& localBuffer() {
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        t_buffer = std::make_shared<ThreadBuffer>(g_registry.size() + 1);
+        g_registry.push_back(t_buffer);
+    }
+    return *t_buffer;
+}
+
+/// Append a string as a JSON string literal; lobby codes come from clients
+void appendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c != '\0'; ++c) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out += escaped;
+        } else {
+            out += *c;
+        }
+    }
+    out += '"';
+}
+
+/// Append one complete ("X") event; times are printed as exact microseconds
+void appendEvent(std::string& out, const SpanRecord& span, size_t threadId) {
+    out += "{\"name\":";
+    appendJsonString(out, span.name);
+
+    char fields[160];
+    std::snprintf(fields, sizeof(fields),
+        ",\"cat\":\"battleship\",\"ph\":\"X\",\"ts\":%llu.%03llu,\"dur\":%llu.%03llu,\"pid\":1,\"tid\":%zu",
+        static_cast<unsigned long long>(span.startNs / 1000), static_cast<unsigned long long>(span.startNs % 1000),
+        static_cast<unsigned long long>(span.durationNs / 1000), static_cast<unsigned long long>(span.durationNs % 1000),
+        threadId);
+    out += fields;
+
+    if (span.lobby[0] != '\0') {
+        out += ",\"args\":{\"lobby\":";
+        appendJsonString(out, span.lobby);
+        out += '}';
+    }
+    out += '}';
+}
+}
+
+void Tracer::setEnabled(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Tracer::isEnabled() {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+uint64_t Tracer::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+void Tracer::record(const char* name, const std::string& lobby, uint64_t startNs, uint64_t endNs) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+
+    SpanRecord& span = buffer.spans[buffer.written % buffer.spans.size()];
+    span.name = name;
+    size_t length = std::min(lobby.size(), sizeof(span.lobby) - 1);
+    std::memcpy(span.lobby, lobby.data(), length);
+    span.lobby[length] = '\0';
+    span.startNs = startNs;
+    span.durationNs = endNs - startNs;
+    buffer.written++;
+}
+
+std::string Tracer::dumpChromeTrace() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        buffers = g_registry;
+    }
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+    for (const std::shared_ptr<ThreadBuffer>& buffer : buffers) {
+        // Copy the raw records so the owning thread only waits for a memcpy
+        std::vector<SpanRecord> spans;
+        uint64_t written;
+        {
+            std::lock_guard<std::mutex> lock(buffer->mutex);
+            spans = buffer->spans;
+            written = buffer->written;
+        }
+
+        size_t capacity = spans.size();
+        uint64_t oldest = written > capacity ? written - capacity : 0;
+        out.reserve(out.size() + (written - oldest) * 112);
+        for (uint64_t i = oldest; i < written; ++i) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            appendEvent(out, spans[i % capacity], buffer->threadId);
+        }
+    }
+    out += "],\"displayTimeUnit\":\"ns\"}";
+    return out;
+}
+
+TraceSpan::TraceSpan(const char* name)
+    : m_name(name), m_active(Tracer::isEnabled()), m_start(m_active ? Tracer::nowNs() : 0) {}
+
+TraceSpan::~TraceSpan() {
+    if (m_active) {
+        Tracer::record(m_name, t_lobby, m_start, Tracer::nowNs());
+    }
+}
+
+void TraceSpan::setLobby(const std::string& lobbyCode) {
+    t_lobby = lobbyCode;
+}
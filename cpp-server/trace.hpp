@@ -0,0 +1,97 @@
+/**
+ * @file trace.hpp
+ * @brief Low-overhead span tracing exported in Chrome trace format
+ */
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+/**
+ * @class Tracer
+ * @brief Collects timed spans into per-thread ring buffers
+ *
+ * Each thread writes to its own fixed-size ring, so recording a span costs
+ * two clock reads and an uncontended lock. Old spans are overwritten once a
+ * ring is full. The buffers can be dumped at any time as Chrome/Perfetto
+ * trace JSON (load it in chrome://tracing or ui.perfetto.dev).
+ */
+class Tracer {
+public:
+    static const size_t kSpansPerThread = 16384;   ///< Ring capacity per thread
+
+    /**
+     * @brief Turn span recording on or off
+     * @param enabled True to record spans
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * @brief Check whether spans are being recorded
+     * @return True if recording is enabled
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Get the current trace clock reading
+     * @return Nanoseconds since the tracer was first used
+     */
+    static uint64_t nowNs();
+
+    /**
+     * @brief Store a finished span in the calling thread's ring
+     * @param name Span name, must be a string literal
+     * @param lobby Lobby code the span belongs to, may be empty
+     * @param startNs Start time from nowNs()
+     * @param endNs End time from nowNs()
+     */
+    static void record(const char* name, const std::string& lobby, uint64_t startNs, uint64_t endNs);
+
+    /**
+     * @brief Export every buffered span
+     *
+     * Rings are copied under their locks and serialized afterwards straight
+     * into the output text, so a full dump stays cheap enough to serve from
+     * the io thread.
+     *
+     * @return Trace in Chrome's JSON object format, already serialized
+     */
+    static std::string dumpChromeTrace();
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records a span covering the lifetime of the object
+ *
+ * Spans are tagged with the lobby set on the current thread when they end,
+ * so a handler can tag the enclosing message spans once it has looked up
+ * which lobby the message belongs to.
+ */
+class TraceSpan {
+public:
+    /**
+     * @brief Start a span
+     * @param name Span name, must be a string literal
+     */
+    explicit TraceSpan(const char* name);
+
+    /**
+     * @brief End the span and record it
+     */
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    /**
+     * @brief Tag spans that end on this thread with a lobby code
+     * @param lobbyCode Lobby code, or empty to clear the tag
+     */
+    static void setLobby(const std::string& lobbyCode);
+
+private:
+    const char* m_name;   ///< Span name
+    bool m_active;        ///< False if tracing was disabled at start
+    uint64_t m_start;     ///< Start time
+};
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Measure server memory per idle WebSocket connection.
+
+Opens N WebSocket connections to the C++ server, leaves them idle, then
+reads the server's /stats endpoint and reports bytes per connection.
+Uses only the standard library so it runs anywhere Python 3 does.
+
+Each source address can hold roughly 28k connections to one server port,
+so pass several --source addresses (e.g. 127.0.0.2, 127.0.0.3, ...) for
+larger runs, and raise the open file limit on both ends.
+"""
+
+import argparse
+import asyncio
+import os
+import resource
+import time
+
+from ws_client import fetch_stats, open_websocket
+
+
+async def open_connection(host, port, source, limiter):
+    """Open one WebSocket connection and return its streams, or None on failure."""
+    async with limiter:
+        try:
+            return await open_websocket(host, port, source)
+        except (OSError, asyncio.IncompleteReadError, asyncio.LimitOverrunError):
+            return None
+
+
+async def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=9002)
+    parser.add_argument("--token", default=os.environ.get("INTERNAL_API_TOKEN", ""),
+                        help="internal token for /stats (default: $INTERNAL_API_TOKEN)")
+    parser.add_argument("--connections", type=int, default=10000)
+    parser.add_argument("--concurrency", type=int, default=500,
+                        help="handshakes in flight at once")
+    parser.add_argument("--source", action="append", default=[],
+                        help="local address to connect from (repeatable)")
+    parser.add_argument("--settle", type=float, default=2.0,
+                        help="seconds to wait before reading stats")
+    args = parser.parse_args()
+
+    soft, hard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    wanted = min(hard, args.connections + 1024)
+    if soft < wanted:
+        resource.setrlimit(resource.RLIMIT_NOFILE, (wanted, hard))
+
+    before = fetch_stats(args.host, args.port, args.token)
+    sources = args.source or [None]
+    limiter = asyncio.Semaphore(args.concurrency)
+
+    started = time.monotonic()
+    results = await asyncio.gather(*(
+        open_connection(args.host, args.port, sources[i % len(sources)], limiter)
+        for i in range(args.connections)
+    ))
+    opened = [r for r in results if r is not None]
+    elapsed = time.monotonic() - started
+
+    await asyncio.sleep(args.settle)
+    after = fetch_stats(args.host, args.port, args.token)
+
+    added = after["connections"] - before["connections"]
+    growth = after["rssBytes"] - before["rssBytes"]
+    print(f"opened {len(opened)}/{args.connections} connections in {elapsed:.1f}s")
+    print(f"server connections: {before['connections']} -> {after['connections']}")
+    print(f"server rss: {before['rssBytes']} -> {after['rssBytes']} bytes")
+    if added > 0:
+        print(f"bytes per idle connection: {growth / added:.0f}")
+
+    for _, writer in opened:
+        writer.close()
+
+
+if __name__ == "__main__":
+    asyncio.run(main())
@@ -0,0 +1,176 @@
+#!/usr/bin/env python3
+"""Soak the C++ server with match lifecycles and fail on leaks.
+
+Runs many two-player matches against a running server. Matches run to
+completion or one player disconnects at a chosen phase (in the lobby, after
+readying up, or mid-game). The /stats endpoint is checked after each round:
+once every client has closed, the server must hold no players, lobbies,
+games or lobby codes, and its live Lobby and Game object counts must be zero.
+Resident memory is compared against the level after the warm-up rounds.
+Exits non-zero if any check fails.
+"""
+
+import argparse
+import asyncio
+import os
+import sys
+import time
+
+from ws_client import Client, fetch_stats
+
+
+PHASES = ["complete", "lobby", "ready", "game"]
+
+# Ship cells as y * 10 + x, matching the ids the web client sends
+BOARD = {
+    "ship5": [0, 1, 2, 3, 4],
+    "ship4": [20, 21, 22, 23],
+    "ship3a": [40, 41, 42],
+    "ship3b": [60, 61, 62],
+    "ship2": [80, 81],
+}
+SHIP_CELLS = [cell for cells in BOARD.values() for cell in cells]
+MISS_CELLS = [y * 10 + x for y in range(1, 10, 2) for x in range(10)]
+
+
+async def run_match(host, port, index, phase):
+    """Play one match, abandoning it at the given phase."""
+    lobby = to_lobby_code(index)
+    users = [f"soak-{index}-a", f"soak-{index}-b"]
+    clients = [await Client.connect(host, port), await Client.connect(host, port)]
+
+    try:
+        for client, user in zip(clients, users):
+            await client.send({"type": "join", "lobby": lobby, "user": user, "username": user})
+            await client.receive_type("joinConfirmed")
+        await clients[0].receive_type("opponentJoined")
+
+        if phase == "lobby":
+            return
+
+        await clients[0].send({"type": "ready", "user": users[0], "board": BOARD})
+        if phase == "ready":
+            return
+        await clients[1].send({"type": "ready", "user": users[1], "board": BOARD})
+
+        starts = [await client.receive_type("gameStart") for client in clients]
+        turn = users.index(starts[0]["firstPlayer"])
+        targets = [list(SHIP_CELLS), list(SHIP_CELLS)]
+        targets[1 - turn] = list(MISS_CELLS)
+
+        moves = 0
+        while True:
+            if phase == "game" and moves == 5:
+                return
+            cell = targets[turn].pop(0)
+            await clients[turn].send({"type": "attack", "x": cell % 10, "y": cell // 10})
+            result = await clients[turn].receive_type("attackResult")
+            await clients[1 - turn].receive_type("attacked")
+            moves += 1
+            if result["gameOver"]:
+                for client in clients:
+                    await client.receive_type("gameOver")
+                return
+            turn = users.index(result["nextPlayer"])
+    finally:
+        # In abandoned phases the first player leaves before the second
+        clients[0].close()
+        await asyncio.sleep(0)
+        clients[1].close()
+
+
+def to_lobby_code(index):
+    """Build a valid 6-character lobby code from a match number."""
+    alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+    code = ""
+    for _ in range(6):
+        index, digit = divmod(index, 36)
+        code = alphabet[digit] + code
+    return code
+
+
+async def wait_for_idle(host, port, token, baseline_connections, timeout=10.0):
+    """Poll /stats until every soak connection has closed."""
+    deadline = time.monotonic() + timeout
+    while True:
+        stats = fetch_stats(host, port, token)
+        if stats["connections"] <= baseline_connections or time.monotonic() > deadline:
+            return stats
+        await asyncio.sleep(0.1)
+
+
+def leaks(stats):
+    """List counters that should have returned to zero."""
+    counters = {
+        "players": stats["players"],
+        "lobbies": stats["lobbies"],
+        "games": stats["games"],
+        "liveLobbyCodes": stats["liveLobbyCodes"],
+        "live Lobby objects": stats["liveObjects"]["lobbies"],
+        "live Game objects": stats["liveObjects"]["games"],
+    }
+    return [f"{name}={value}" for name, value in counters.items() if value != 0]
+
+
+async def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=9002)
+    parser.add_argument("--token", default=os.environ.get("INTERNAL_API_TOKEN", ""),
+                        help="internal token for /stats (default: $INTERNAL_API_TOKEN)")
+    parser.add_argument("--matches", type=int, default=1000000)
+    parser.add_argument("--round-size", type=int, default=500,
+                        help="matches in flight at once; stats are checked between rounds")
+    parser.add_argument("--warmup-rounds", type=int, default=5)
+    parser.add_argument("--rss-tolerance-mb", type=float, default=16.0,
+                        help="allowed RSS growth over the post-warm-up level")
+    args = parser.parse_args()
+
+    baseline = fetch_stats(args.host, args.port, args.token)
+    if leaks(baseline):
+        print(f"server is not idle before the soak: {', '.join(leaks(baseline))}")
+        return 1
+
+    warm_rss = None
+    started = time.monotonic()
+    completed = 0
+    round_number = 0
+
+    while completed < args.matches:
+        count = min(args.round_size, args.matches - completed)
+        results = await asyncio.gather(*(
+            run_match(args.host, args.port, completed + i, PHASES[(completed + i) % len(PHASES)])
+            for i in range(count)
+        ), return_exceptions=True)
+        errors = [r for r in results if isinstance(r, Exception)]
+        completed += count
+        round_number += 1
+
+        stats = await wait_for_idle(args.host, args.port, args.token, baseline["connections"])
+        rss_mb = stats["rssBytes"] / (1024 * 1024)
+        rate = completed / (time.monotonic() - started)
+        print(f"{completed} matches, {rate:.0f}/s, rss {rss_mb:.1f} MB, "
+              f"lobbies created {stats['createdObjects']['lobbies']}, "
+              f"games created {stats['createdObjects']['games']}, errors {len(errors)}")
+
+        if errors:
+            print(f"match failed: {errors[0]!r}")
+            return 1
+
+        leaked = leaks(stats)
+        if leaked:
+            print(f"leak after {completed} matches: {', '.join(leaked)}")
+            return 1
+
+        if round_number == args.warmup_rounds:
+            warm_rss = rss_mb
+        elif warm_rss is not None and rss_mb > warm_rss + args.rss_tolerance_mb:
+            print(f"RSS drifted from {warm_rss:.1f} MB to {rss_mb:.1f} MB")
+            return 1
+
+    print("soak passed")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(asyncio.run(main()))
@@ -0,0 +1,100 @@
+"""Minimal WebSocket client helpers shared by the server tools.
+
+Standard library only: the opening handshake, text frames and the /stats
+endpoint, which is all idle_connections.py and soak.py need.
+"""
+
+import asyncio
+import base64
+import json
+import os
+import struct
+import urllib.request
+
+
+HANDSHAKE = (
+    "GET / HTTP/1.1\r\n"
+    "Host: {host}:{port}\r\n"
+    "Upgrade: websocket\r\n"
+    "Connection: Upgrade\r\n"
+    "Sec-WebSocket-Key: {key}\r\n"
+    "Sec-WebSocket-Version: 13\r\n"
+    "\r\n"
+)
+
+
+async def open_websocket(host, port, source=None):
+    """Connect and complete the WebSocket handshake.
+
+    Returns the (reader, writer) stream pair. Raises ConnectionError if the
+    server refuses the upgrade.
+    """
+    local_addr = (source, 0) if source else None
+    reader, writer = await asyncio.open_connection(host, port, local_addr=local_addr)
+    key = base64.b64encode(os.urandom(16)).decode()
+    writer.write(HANDSHAKE.format(host=host, port=port, key=key).encode())
+    await writer.drain()
+    response = await reader.readuntil(b"\r\n\r\n")
+    if b" 101 " not in response.split(b"\r\n", 1)[0]:
+        writer.close()
+        raise ConnectionError("WebSocket handshake rejected")
+    return reader, writer
+
+
+class Client:
+    """WebSocket client speaking JSON text frames."""
+
+    def __init__(self, reader, writer):
+        self.reader = reader
+        self.writer = writer
+
+    @classmethod
+    async def connect(cls, host, port, source=None):
+        return cls(*await open_websocket(host, port, source))
+
+    async def send(self, message):
+        payload = json.dumps(message).encode()
+        mask = os.urandom(4)
+        length = len(payload)
+        if length < 126:
+            header = struct.pack("!BB", 0x81, 0x80 | length)
+        elif length < 65536:
+            header = struct.pack("!BBH", 0x81, 0x80 | 126, length)
+        else:
+            header = struct.pack("!BBQ", 0x81, 0x80 | 127, length)
+        masked = bytes(b ^ mask[i % 4] for i, b in enumerate(payload))
+        self.writer.write(header + mask + masked)
+        await self.writer.drain()
+
+    async def receive(self):
+        """Return the next JSON message, skipping control frames."""
+        while True:
+            first, second = await self.reader.readexactly(2)
+            length = second & 0x7F
+            if length == 126:
+                (length,) = struct.unpack("!H", await self.reader.readexactly(2))
+            elif length == 127:
+                (length,) = struct.unpack("!Q", await self.reader.readexactly(8))
+            payload = await self.reader.readexactly(length)
+            opcode = first & 0x0F
+            if opcode == 0x8:
+                raise ConnectionError("server closed the connection")
+            if opcode == 0x1:
+                return json.loads(payload)
+
+    async def receive_type(self, message_type):
+        while True:
+            message = await self.receive()
+            if message.get("type") == message_type:
+                return message
+
+    def close(self):
+        self.writer.close()
+
+
+def fetch_stats(host, port, token):
+    """Read the server's stats endpoint, which requires the internal token."""
+    request = urllib.request.Request(f"http://{host}:{port}/stats",
+                                     headers={"X-Internal-Token": token})
+    with urllib.request.urlopen(request, timeout=10) as response:
+        return json.loads(response.read())